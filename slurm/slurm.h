@@ -3141,6 +3141,12 @@ typedef struct slurmd_status_msg {
 	char *slurmd_logfile;		/* slurmd log file location */
 	char *step_list;		/* list of active job steps */
 	char *version;			/* version running */
+	uint32_t prep_queued;		/* prolog/epilog waiting for a slot */
+	uint32_t prep_running;		/* prolog/epilog running now */
+	uint32_t prep_wait_max;		/* longest slot wait in msec */
+	uint32_t prep_hist_cnt;		/* prolog_hist/epilog_hist entries */
+	uint32_t *prolog_hist;		/* prolog run time histogram */
+	uint32_t *epilog_hist;		/* epilog run time histogram */
 } slurmd_status_t;
 
 typedef struct submit_response_msg {
@@ -3257,6 +3263,13 @@ typedef struct stats_info_response_msg {
 	time_t   bf_when_last_cycle;
 	uint32_t bf_active;
 
+	uint32_t prep_script_cnt;
+	uint32_t prep_script_inflight;
+	uint32_t prep_script_queue_max;
+	uint64_t prep_script_queue_sum;
+	uint32_t prep_script_run_max;
+	uint64_t prep_script_run_sum;
+
 	uint32_t rpc_type_size;
 	uint16_t *rpc_type_id;
 	uint32_t *rpc_type_cnt;
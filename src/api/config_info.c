@@ -1998,6 +1998,18 @@ slurm_load_slurmd_status(slurmd_status_t **slurmd_status_ptr)
 	return SLURM_SUCCESS;
 }
 
+static void _write_prep_hist(FILE *out, char *title, uint32_t *hist,
+			     uint32_t hist_cnt)
+{
+	fprintf(out, "%s", title);
+	if (!hist_cnt)
+		fprintf(out, "N/A");
+	for (int i = 0; i < hist_cnt; i++)
+		fprintf(out, "%s%s:%u", (i ? " " : ""),
+			prep_hist_inx2str(i), hist[i]);
+	fprintf(out, "\n");
+}
+
 /*
  * slurm_print_slurmd_status - output the contents of slurmd status
  *	message as loaded using slurm_load_slurmd_status
@@ -2045,6 +2057,19 @@ void slurm_print_slurmd_status (FILE* out,
 	} else
 		fprintf(out, "Last slurmctld msg time  = NONE\n");
 
+	fprintf(out, "Prolog/Epilog queued     = %u\n",
+		slurmd_status_ptr->prep_queued);
+	fprintf(out, "Prolog/Epilog running    = %u\n",
+		slurmd_status_ptr->prep_running);
+	fprintf(out, "Prolog/Epilog max wait   = %u ms\n",
+		slurmd_status_ptr->prep_wait_max);
+	_write_prep_hist(out, "Prolog run times         = ",
+			 slurmd_status_ptr->prolog_hist,
+			 slurmd_status_ptr->prep_hist_cnt);
+	_write_prep_hist(out, "Epilog run times         = ",
+			 slurmd_status_ptr->epilog_hist,
+			 slurmd_status_ptr->prep_hist_cnt);
+
 	fprintf(out, "Slurmd PID               = %u\n",
 		slurmd_status_ptr->pid);
 	fprintf(out, "Slurmd Debug             = %u\n",
@@ -61,6 +61,14 @@
 
 #define STDIO_MAX_FREE_BUF 1024
 
+/*
+ * Messages handled per socket or file event. Every stepd of the step has
+ * its own I/O connection to srun, so with thousands of them each eio pass
+ * polls them all. Move more than one message per pass when it is already
+ * waiting.
+ */
+#define STDIO_MAX_MSGS_PER_EVENT 16
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -80,6 +88,7 @@ static void	_handle_io_init_msg(int fd, client_io_t *cio);
 static int _read_io_init_msg(int fd, client_io_t *cio, slurm_addr_t *host);
 static int      _wid(int n);
 static bool     _incoming_buf_free(client_io_t *cio);
+static bool     _is_fd_ready(int fd, int timeout);
 static bool     _outgoing_buf_free(client_io_t *cio);
 
 /**********************************************************************
@@ -282,14 +291,13 @@ _server_readable(eio_obj_t *obj)
 	return false;
 }
 
-static int
-_server_read(eio_obj_t *obj, List objs)
+static int _server_read_msg(eio_obj_t *obj)
 {
 	struct server_io_info *s = (struct server_io_info *) obj->arg;
 	void *buf;
 	int n;
 
-	debug4("Entering _server_read");
+	debug4("Entering %s", __func__);
 	if (s->in_msg == NULL) {
 		if (_outgoing_buf_free(s->cio)) {
 			s->in_msg = list_dequeue(s->cio->free_outgoing);
@@ -435,6 +443,24 @@ _server_read(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+static int
+_server_read(eio_obj_t *obj, List objs)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+	int i, rc = SLURM_SUCCESS;
+
+	for (i = 0; i < STDIO_MAX_MSGS_PER_EVENT; i++) {
+		rc = _server_read_msg(obj);
+		/* stop on partial message, eof or no more buffered data */
+		if (rc || s->in_msg || s->in_eof || obj->shutdown ||
+		    (obj->fd < 0) || !_outgoing_buf_free(s->cio) ||
+		    !_is_fd_ready(obj->fd, 0))
+			break;
+	}
+
+	return rc;
+}
+
 static bool
 _server_writable(eio_obj_t *obj)
 {
@@ -567,7 +593,7 @@ static bool _file_writable(eio_obj_t *obj)
 	return false;
 }
 
-static int _file_write(eio_obj_t *obj, List objs)
+static int _file_write_msg(eio_obj_t *obj)
 {
 	struct file_write_info *info = (struct file_write_info *) obj->arg;
 	void *ptr;
@@ -626,6 +652,21 @@ static int _file_write(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+static int _file_write(eio_obj_t *obj, List objs)
+{
+	struct file_write_info *info = (struct file_write_info *) obj->arg;
+	int i, rc = SLURM_SUCCESS;
+
+	for (i = 0; i < STDIO_MAX_MSGS_PER_EVENT; i++) {
+		rc = _file_write_msg(obj);
+		/* stop on a partial write or once the queue is drained */
+		if (rc || info->out_msg || list_is_empty(info->msg_queue))
+			break;
+	}
+
+	return rc;
+}
+
 /**********************************************************************
  * File read functions
  **********************************************************************/
@@ -888,7 +929,7 @@ static int _read_io_init_msg(int fd, client_io_t *cio, slurm_addr_t *host)
 
 
 static bool
-_is_fd_ready(int fd)
+_is_fd_ready(int fd, int timeout)
 {
 	struct pollfd pfd[1];
 	int    rc;
@@ -896,7 +937,7 @@ _is_fd_ready(int fd)
 	pfd[0].fd     = fd;
 	pfd[0].events = POLLIN;
 
-	rc = poll(pfd, 1, 10);
+	rc = poll(pfd, 1, timeout);
 
 	return ((rc == 1) && (pfd[0].revents & POLLIN));
 }
@@ -915,7 +956,7 @@ _handle_io_init_msg(int fd, client_io_t *cio)
 		/*
 		 * Return early if fd is not now ready
 		 */
-		if (!_is_fd_ready(fd))
+		if (!_is_fd_ready(fd, 10))
 			return;
 
 		while ((sd = slurm_accept_msg_conn(fd, &addr)) < 0) {
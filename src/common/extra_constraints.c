@@ -256,6 +256,29 @@ static char *_find_op_in_string(char *str)
 	return NULL;
 }
 
+/*
+ * Convert the leaf value to the numeric types it may be compared against so
+ * that testing the leaf against every node does not repeat the conversion.
+ */
+static void _convert_leaf_value(elem_t *leaf)
+{
+	data_t *value_d = data_new();
+
+	data_set_string(value_d, leaf->value);
+	if (data_convert_type(value_d, DATA_TYPE_FLOAT) == DATA_TYPE_FLOAT) {
+		leaf->value_float = data_get_float(value_d);
+		leaf->value_float_valid = true;
+	}
+
+	data_set_string(value_d, leaf->value);
+	if (data_convert_type(value_d, DATA_TYPE_BOOL) == DATA_TYPE_BOOL) {
+		leaf->value_bool = data_get_bool(value_d);
+		leaf->value_bool_valid = true;
+	}
+
+	FREE_NULL_DATA(value_d);
+}
+
 /*
  * Leaf:
  * <key><op><value>
@@ -344,6 +367,7 @@ static elem_t *_parse_leaf(char *str)
 	leaf->operator = op;
 	leaf->key = key; /* Already malloc'd */
 	leaf->value = xstrdup(val);
+	_convert_leaf_value(leaf);
 
 #if _DEBUG
 	_log_element(leaf);
@@ -610,27 +634,18 @@ do {\
 
 
 /*
- * Test if "data" equals, is less than, or is greater than "value"
+ * Test if "data" equals, is less than, or is greater than the leaf value
  * data.c already has data_check_match(); however, that only checks for
  * equality and is stricter than we want to be here.
  */
-static cmp_t _compare(data_t *data, char *value)
+static cmp_t _compare(data_t *data, elem_t *leaf)
 {
 	cmp_t comparison;
 	data_type_t data_type;
-	data_t *value_d;
 
-	xassert(value);
+	xassert(leaf->value);
 	xassert(data);
 
-	value_d = data_new();
-	if (!data_set_string(value_d, value)) {
-		data_free(value_d);
-#if _DEBUG
-		error("%s: Couldn't convert %s to data_t", __func__, value);
-#endif
-		return CMP_INVALID;
-	}
 	data_type = data_get_type(data);
 
 	switch (data_type) {
@@ -642,13 +657,11 @@ static cmp_t _compare(data_t *data, char *value)
 		 * integer and floating point on node updates.
 		 */
 		double tmp1 = (double) data_get_int(data);
-		double tmp2;
+		double tmp2 = leaf->value_float;
 
-		if (data_convert_type(value_d, DATA_TYPE_FLOAT) !=
-		    DATA_TYPE_FLOAT) {
+		if (!leaf->value_float_valid) {
 			comparison = CMP_INVALID;
 		} else {
-			tmp2 = data_get_float(value_d);
 			NUMBER_COMPARE(tmp1, tmp2, true, comparison);
 		}
 		break;
@@ -659,7 +672,7 @@ static cmp_t _compare(data_t *data, char *value)
 		 * is guaranteed to return a negative number, zero, or a
 		 * positive number. Convert those to our CMP_* values.
 		 */
-		comparison = xstrcmp(data_get_string(data), value);
+		comparison = xstrcmp(data_get_string(data), leaf->value);
 		if (comparison < 0)
 			comparison = CMP_LT;
 		else if (comparison > 0)
@@ -670,13 +683,11 @@ static cmp_t _compare(data_t *data, char *value)
 	case DATA_TYPE_FLOAT:
 	{
 		double tmp1 = data_get_float(data);
-		double tmp2;
+		double tmp2 = leaf->value_float;
 
-		if (data_convert_type(value_d, DATA_TYPE_FLOAT) !=
-		    DATA_TYPE_FLOAT) {
+		if (!leaf->value_float_valid) {
 			comparison = CMP_INVALID;
 		} else {
-			tmp2 = data_get_float(value_d);
 			NUMBER_COMPARE(tmp1, tmp2, true, comparison);
 		}
 		break;
@@ -684,13 +695,11 @@ static cmp_t _compare(data_t *data, char *value)
 	case DATA_TYPE_BOOL:
 	{
 		bool tmp1 = data_get_bool(data);
-		bool tmp2;
+		bool tmp2 = leaf->value_bool;
 
-		if (data_convert_type(value_d, DATA_TYPE_BOOL) !=
-		    DATA_TYPE_BOOL) {
+		if (!leaf->value_bool_valid) {
 			comparison = CMP_INVALID;
 		} else {
-			tmp2 = data_get_bool(value_d);
 			NUMBER_COMPARE(tmp1, tmp2, false, comparison);
 		}
 		break;
@@ -703,7 +712,6 @@ static cmp_t _compare(data_t *data, char *value)
 #endif
 		break;
 	}
-	FREE_NULL_DATA(value_d);
 	return comparison;
 }
 
@@ -764,7 +772,7 @@ static bool _test_extra_constraints(elem_t *parent, elem_t *el, data_t *data)
 			data_str = xstrdup_printf("<Couldn't convert data to string>");
 		}
 #endif
-		comparison = _compare(data_ptr, el->value);
+		comparison = _compare(data_ptr, el);
 		if (comparison == CMP_INVALID) {
 #if _DEBUG
 			info("%s: Invalid comparison: \"%s\" %s \"%s\"",
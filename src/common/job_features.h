@@ -59,6 +59,10 @@ typedef struct {
 	bool changeable;		/* return value of
 					 * node_features_g_changeable_feature */
 	uint16_t count;			/* count of nodes with this feature */
+	uint32_t feature_epoch;		/* feature_list_epoch the node bitmaps
+					 * were resolved against, 0 if never */
+	bool feature_reboot;		/* node_bitmap_avail resolved from
+					 * avail_feature_list */
 	uint8_t op_code;		/* separator, see FEATURE_OP_ above */
 	bitstr_t *node_bitmap_active;	/* nodes with this feature active */
 	bitstr_t *node_bitmap_avail;	/* nodes with this feature available */
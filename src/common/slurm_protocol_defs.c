@@ -4735,7 +4735,9 @@ extern void slurm_free_ctl_conf(slurm_ctl_conf_info_msg_t * config_ptr)
 extern void slurm_free_slurmd_status(slurmd_status_t* slurmd_status_ptr)
 {
 	if (slurmd_status_ptr) {
+		xfree(slurmd_status_ptr->epilog_hist);
 		xfree(slurmd_status_ptr->hostname);
+		xfree(slurmd_status_ptr->prolog_hist);
 		xfree(slurmd_status_ptr->slurmd_logfile);
 		xfree(slurmd_status_ptr->step_list);
 		xfree(slurmd_status_ptr->version);
@@ -6678,6 +6680,31 @@ extern void print_multi_line_string(char *user_msg, int inx,
 	xfree(buf);
 }
 
+extern int prep_hist_inx(uint32_t msec)
+{
+	static const uint32_t limit[PREP_HIST_CNT - 1] =
+		{ 100, 1000, 10000, 60000, 600000 };
+	int inx;
+
+	for (inx = 0; inx < (PREP_HIST_CNT - 1); inx++) {
+		if (msec < limit[inx])
+			break;
+	}
+
+	return inx;
+}
+
+extern const char *prep_hist_inx2str(int inx)
+{
+	static const char *label[PREP_HIST_CNT] =
+		{ "<100ms", "<1s", "<10s", "<1m", "<10m", ">=10m" };
+
+	if ((inx < 0) || (inx >= PREP_HIST_CNT))
+		return "unknown";
+
+	return label[inx];
+}
+
 /*
  * Given a numeric suffix, return the equivalent multiplier for the numeric
  * portion. For example: "k" returns 1024, "KB" returns 1000, etc.
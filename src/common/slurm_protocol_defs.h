@@ -1915,6 +1915,16 @@ extern void print_multi_line_string(char *user_msg, int inx,
  */
 extern char *rpc_num2string(uint16_t opcode);
 
+/*
+ * Prolog/Epilog run time histogram reported by slurmd in slurmd_status_t.
+ * Buckets are <100ms, <1s, <10s, <1m, <10m and >=10m.
+ */
+#define PREP_HIST_CNT 6
+/* Return the histogram bucket for a run time in milliseconds */
+extern int prep_hist_inx(uint32_t msec);
+/* Return the label of a histogram bucket */
+extern const char *prep_hist_inx2str(int inx);
+
 /*
  * Given a numeric suffix, return the equivalent multiplier for the numeric
  * portion. For example: "k" returns 1024, "KB" returns 1000, etc.
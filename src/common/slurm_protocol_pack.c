@@ -8920,6 +8920,16 @@ static void _pack_slurmd_status(slurmd_status_t *msg, buf_t *buffer,
 		packstr(msg->slurmd_logfile, buffer);
 		packstr(msg->step_list, buffer);
 		packstr(msg->version, buffer);
+
+		if (protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+			pack32(msg->prep_queued, buffer);
+			pack32(msg->prep_running, buffer);
+			pack32(msg->prep_wait_max, buffer);
+			pack32_array(msg->prolog_hist, msg->prep_hist_cnt,
+				     buffer);
+			pack32_array(msg->epilog_hist, msg->prep_hist_cnt,
+				     buffer);
+		}
 	}
 }
 
@@ -8951,6 +8961,20 @@ static int _unpack_slurmd_status(slurmd_status_t **msg_ptr, buf_t *buffer,
 		safe_unpackstr(&msg->slurmd_logfile, buffer);
 		safe_unpackstr(&msg->step_list, buffer);
 		safe_unpackstr(&msg->version, buffer);
+
+		if (protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+			uint32_t uint32_tmp;
+
+			safe_unpack32(&msg->prep_queued, buffer);
+			safe_unpack32(&msg->prep_running, buffer);
+			safe_unpack32(&msg->prep_wait_max, buffer);
+			safe_unpack32_array(&msg->prolog_hist,
+					    &msg->prep_hist_cnt, buffer);
+			safe_unpack32_array(&msg->epilog_hist, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->prep_hist_cnt)
+				goto unpack_error;
+		}
 	}
 
 	*msg_ptr = msg;
@@ -9359,6 +9383,21 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 			safe_unpack32(&msg->bf_backfilled_het_jobs, buffer);
 			safe_unpack32_array(&msg->bf_exit,
 					    &msg->bf_exit_cnt, buffer);
+
+			if (protocol_version >=
+			    SLURM_24_08_PROTOCOL_VERSION) {
+				safe_unpack32(&msg->prep_script_inflight,
+					      buffer);
+				safe_unpack32(&msg->prep_script_cnt, buffer);
+				safe_unpack64(&msg->prep_script_queue_sum,
+					      buffer);
+				safe_unpack32(&msg->prep_script_queue_max,
+					      buffer);
+				safe_unpack64(&msg->prep_script_run_sum,
+					      buffer);
+				safe_unpack32(&msg->prep_script_run_max,
+					      buffer);
+			}
 		}
 
 		safe_unpack32(&msg->rpc_type_size, buffer);
@@ -0,0 +1,65 @@
+/*****************************************************************************\
+ *  sort_keys.c - sort by several keys in a single pass
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "src/common/sort_keys.h"
+#include "src/common/xmalloc.h"
+
+extern void sort_keys_add(sort_keys_t *sort_keys, sort_key_cmp_f cmp,
+			  bool reverse)
+{
+	xrecalloc(sort_keys->keys, sort_keys->cnt + 1, sizeof(sort_key_t));
+	sort_keys->keys[sort_keys->cnt].cmp = cmp;
+	sort_keys->keys[sort_keys->cnt].reverse = reverse;
+	sort_keys->cnt++;
+}
+
+extern void sort_keys_clear(sort_keys_t *sort_keys)
+{
+	xfree(sort_keys->keys);
+	sort_keys->cnt = 0;
+}
+
+extern int sort_keys_cmp(sort_keys_t *sort_keys, bool *reverse,
+			 void *x, void *y)
+{
+	int diff = 0;
+
+	for (int i = sort_keys->cnt - 1; (i >= 0) && !diff; i--) {
+		*reverse = sort_keys->keys[i].reverse;
+		diff = (sort_keys->keys[i].cmp)(x, y);
+	}
+
+	return diff;
+}
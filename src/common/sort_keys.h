@@ -0,0 +1,72 @@
+/*****************************************************************************\
+ *  sort_keys.h - sort by several keys in a single pass
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SORT_KEYS_H
+#define _SORT_KEYS_H
+
+#include <stdbool.h>
+
+typedef int (*sort_key_cmp_f)(void *x, void *y);
+
+typedef struct {
+	sort_key_cmp_f cmp;
+	bool reverse;
+} sort_key_t;
+
+/*
+ * Sort keys are added least significant first, which is the order in which
+ * the commands parse their sort specification (from the end of the string).
+ */
+typedef struct {
+	sort_key_t *keys;
+	int cnt;
+} sort_keys_t;
+
+/* Append a key, more significant than all keys added before it */
+extern void sort_keys_add(sort_keys_t *sort_keys, sort_key_cmp_f cmp,
+			  bool reverse);
+
+/* Release all keys, leaving an empty (reusable) set */
+extern void sort_keys_clear(sort_keys_t *sort_keys);
+
+/*
+ * Compare x and y by every key, most significant first, and return the first
+ * non-zero result. The comparison functions read the direction of their key
+ * from *reverse, which is set before each one is called.
+ */
+extern int sort_keys_cmp(sort_keys_t *sort_keys, bool *reverse,
+			 void *x, void *y);
+
+#endif
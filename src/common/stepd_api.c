@@ -41,6 +41,7 @@
 #define _GNU_SOURCE
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <grp.h>
 #include <inttypes.h>
 #include <netdb.h>
@@ -663,6 +664,11 @@ stepd_cleanup_sockets(const char *directory, const char *nodename)
 				rc = SLURM_ERROR;
 			}
 			xfree(path);
+
+			path = stepd_stat_snapshot_name(directory, nodename,
+							&step_id);
+			(void) unlink(path);
+			xfree(path);
 		}
 	}
 
@@ -1228,6 +1234,117 @@ rwfail:
 	return rc;
 }
 
+extern char *stepd_stat_snapshot_name(const char *directory,
+				      const char *nodename,
+				      slurm_step_id_t *step_id)
+{
+	char *name = NULL, *pos = NULL;
+
+	xstrfmtcatat(name, &pos, "%s/%s_%u.%u", directory, nodename,
+		     step_id->job_id, step_id->step_id);
+	if (step_id->step_het_comp != NO_VAL)
+		xstrfmtcatat(name, &pos, ".%u", step_id->step_het_comp);
+	xstrfmtcatat(name, &pos, ".stat");
+
+	return name;
+}
+
+extern int stepd_stat_snapshot_write(const char *name, uid_t uid,
+				     uint16_t max_age, jobacctinfo_t *jobacct,
+				     uint32_t num_tasks, uint32_t *pids,
+				     uint32_t pid_cnt)
+{
+	buf_t *buffer = init_buf(BUF_SIZE);
+	char *tmp_name = NULL;
+	int fd = -1;
+
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(time(NULL), buffer);
+	pack16(max_age, buffer);
+	pack32(uid, buffer);
+	pack32(num_tasks, buffer);
+	pack32_array(pids, pid_cnt, buffer);
+	jobacctinfo_pack(jobacct, SLURM_PROTOCOL_VERSION, PROTOCOL_TYPE_SLURM,
+			 buffer);
+
+	/* Readers mmap() the file, so replace it rather than rewrite it */
+	xstrfmtcat(tmp_name, "%s.new", name);
+	if ((fd = open(tmp_name, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC,
+		       0600)) < 0) {
+		error("%s: open(%s): %m", __func__, tmp_name);
+		goto rwfail;
+	}
+	safe_write(fd, get_buf_data(buffer), get_buf_offset(buffer));
+	if (close(fd) < 0) {
+		fd = -1;
+		error("%s: close(%s): %m", __func__, tmp_name);
+		goto rwfail;
+	}
+	fd = -1;
+	if (rename(tmp_name, name) < 0) {
+		error("%s: rename(%s, %s): %m", __func__, tmp_name, name);
+		goto rwfail;
+	}
+
+	xfree(tmp_name);
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_SUCCESS;
+
+rwfail:
+	if (fd >= 0)
+		close(fd);
+	(void) unlink(tmp_name);
+	xfree(tmp_name);
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_ERROR;
+}
+
+extern int stepd_stat_snapshot_read(const char *directory,
+				    const char *nodename,
+				    slurm_step_id_t *step_id, uid_t *uid,
+				    job_step_stat_t *resp)
+{
+	char *name = stepd_stat_snapshot_name(directory, nodename, step_id);
+	buf_t *buffer = create_mmap_buf(name);
+	jobacctinfo_t *jobacct = NULL;
+	uint32_t *pids = NULL, pid_cnt = 0, num_tasks, tmp32;
+	uint16_t protocol_version, max_age;
+	time_t snapshot_time;
+
+	xfree(name);
+	if (!buffer)
+		return SLURM_ERROR;
+
+	safe_unpack16(&protocol_version, buffer);
+	if (protocol_version != SLURM_PROTOCOL_VERSION)
+		goto unpack_error;
+	safe_unpack_time(&snapshot_time, buffer);
+	safe_unpack16(&max_age, buffer);
+	/* Only the latest poll, a stale file is from a step which is gone */
+	if ((time(NULL) - snapshot_time) > max_age)
+		goto unpack_error;
+	safe_unpack32(&tmp32, buffer);
+	*uid = (uid_t) tmp32;
+	safe_unpack32(&num_tasks, buffer);
+	safe_unpack32_array(&pids, &pid_cnt, buffer);
+	if (jobacctinfo_unpack(&jobacct, protocol_version, PROTOCOL_TYPE_SLURM,
+			       buffer, true) != SLURM_SUCCESS)
+		goto unpack_error;
+	FREE_NULL_BUFFER(buffer);
+
+	resp->jobacct = jobacct;
+	resp->num_tasks = num_tasks;
+	resp->step_pids->pid = pids;
+	resp->step_pids->pid_cnt = pid_cnt;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(pids);
+	jobacctinfo_destroy(jobacct);
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_ERROR;
+}
+
 /*
  * List all of task process IDs and their local and global Slurm IDs.
  *
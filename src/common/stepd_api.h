@@ -308,6 +308,37 @@ int stepd_task_info(int fd, uint16_t protocol_version,
 int stepd_list_pids(int fd, uint16_t protocol_version,
 		    uint32_t **pids_array, uint32_t *pids_count);
 
+/*
+ * With JobAcctGatherParams=StatSnapshot, a step's statistics snapshot is
+ * written by its slurmstepd after periodic accounting polls, next to the
+ * step's socket, so that slurmd can answer REQUEST_JOB_STEP_STAT from it
+ * without a request to the slurmstepd.
+ *
+ * Return the file name of the snapshot, caller must xfree().
+ */
+extern char *stepd_stat_snapshot_name(const char *directory,
+				      const char *nodename,
+				      slurm_step_id_t *step_id);
+
+/*
+ * Replace the snapshot file "name". Readers accept it for max_age seconds.
+ * Returns SLURM_SUCCESS or SLURM_ERROR.
+ */
+extern int stepd_stat_snapshot_write(const char *name, uid_t uid,
+				     uint16_t max_age, jobacctinfo_t *jobacct,
+				     uint32_t num_tasks, uint32_t *pids,
+				     uint32_t pid_cnt);
+
+/*
+ * Read the snapshot of a step into resp (jobacct, num_tasks and
+ * step_pids->pid) and set uid to the owner of the step.
+ * Returns SLURM_ERROR if there is no current snapshot of the step.
+ */
+extern int stepd_stat_snapshot_read(const char *directory,
+				    const char *nodename,
+				    slurm_step_id_t *step_id, uid_t *uid,
+				    job_step_stat_t *resp);
+
 /*
  * Get the memory limits of the step
  * Returns uid of the running step if successful.  On error returns -1.
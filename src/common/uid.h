@@ -120,6 +120,15 @@ extern char *uid_to_shell(uid_t uid);
  */
 extern char *gid_to_string(gid_t gid);
 
+/* Free any memory allocated by gid_to_string_cached() */
+extern void gid_cache_clear(void);
+
+/*
+ * Translate gid to group name, using a cache.
+ * Call gid_cache_clear() to free memory.
+ */
+extern char *gid_to_string_cached(gid_t gid);
+
 /*
  * Translate gid to user name.
  * Will return NULL on error.
@@ -115,6 +115,18 @@ static List task_list = NULL;
 static uint64_t cont_id = NO_VAL64;
 static pthread_mutex_t task_list_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Statistics requests (e.g. sstat) arriving within STAT_POLL_MIN_USEC of the
+ * previous poll are answered from the data already gathered rather than
+ * walking all of the step's processes again. last_poll_tv is protected by
+ * task_list_lock.
+ */
+#define STAT_POLL_MIN_USEC 1000000
+static struct timeval last_poll_tv = { 0, 0 };
+
+/* Called by the polling thread after each periodic poll */
+static void (*poll_callback)(uint16_t frequency) = NULL;
+
 static bool jobacct_shutdown = true;
 static pthread_mutex_t jobacct_shutdown_mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -318,11 +330,28 @@ static void _poll_data(bool profile)
 {
 	/* Update the data */
 	slurm_mutex_lock(&task_list_lock);
-	if (task_list)
+	if (task_list) {
 		(*(ops.poll_data))(task_list, cont_id, profile);
+		/* Plugins skip the poll until the container is known */
+		if (cont_id != NO_VAL64)
+			gettimeofday(&last_poll_tv, NULL);
+	}
 	slurm_mutex_unlock(&task_list_lock);
 }
 
+/* Return true if the task data was polled within STAT_POLL_MIN_USEC */
+static bool _poll_data_recent(void)
+{
+	bool rc;
+
+	slurm_mutex_lock(&task_list_lock);
+	rc = (last_poll_tv.tv_sec &&
+	      (slurm_delta_tv(&last_poll_tv) < STAT_POLL_MIN_USEC));
+	slurm_mutex_unlock(&task_list_lock);
+
+	return rc;
+}
+
 static bool _init_run_test(void)
 {
 	bool rc;
@@ -360,6 +389,8 @@ static void *_watch_tasks(void *arg)
 		_poll_data(1);
 		slurm_mutex_unlock(&g_context_lock);
 
+		if (poll_callback)
+			(*poll_callback)(freq);
 	}
 	return NULL;
 }
@@ -689,12 +720,22 @@ error:
 	return SLURM_ERROR;
 }
 
+extern void jobacct_gather_set_poll_callback(void (*callback)(
+						uint16_t frequency))
+{
+	poll_callback = callback;
+}
+
 extern jobacctinfo_t *jobacct_gather_stat_task(pid_t pid, bool update_data)
 {
 	if ((plugin_inited == PLUGIN_NOOP) || _jobacct_shutdown_test())
 		return NULL;
 
-	if (update_data)
+	/*
+	 * A pid means a statistics request, which can reuse a recent poll.
+	 * Without a pid the caller explicitly wants fresh data.
+	 */
+	if (update_data && (!pid || !_poll_data_recent()))
 		_poll_data(0);
 
 	if (pid) {
@@ -131,6 +131,12 @@ extern int  jobacct_gather_startpoll(uint16_t frequency);
 extern int  jobacct_gather_endpoll(void);
 extern void jobacct_gather_suspend_poll(void);
 extern void jobacct_gather_resume_poll(void);
+/*
+ * Register a function for the polling thread to call after each periodic
+ * poll, with the polling frequency in seconds.
+ */
+extern void jobacct_gather_set_poll_callback(void (*callback)(
+						uint16_t frequency));
 
 extern int jobacct_gather_add_task(pid_t pid, jobacct_id_t *jobacct_id,
 				   int poll);
@@ -55,6 +55,8 @@
 #include "src/common/xstring.h"
 #include "src/interfaces/proctrack.h"
 
+#include "src/slurmd/slurmd/slurmd.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -126,6 +128,7 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 static acct_gather_energy_t *local_energy = NULL;
 
 static int dataset_id = -1; /* id of the dataset for profile data */
+static int context_id = -1;
 
 /* one cpu in the package */
 static int pkg2cpu[MAX_PKGS] = {[0 ... MAX_PKGS-1] = -1};
@@ -298,19 +301,21 @@ _send_drain_request(void)
 	}
 }
 
-static void _get_joules_task(acct_gather_energy_t *energy)
+/*
+ * Read the node's total package and DRAM energy from the MSRs.
+ * Only slurmd reads the MSRs, steps get the readings from slurmd.
+ */
+static int _read_joules(double *joules)
 {
 	int i;
 	double energy_units;
 	uint64_t result;
-	double ret;
-	static uint32_t readings = 0;
 
 	if (pkg_fd[0] < 0) {
 		error("%s: device /dev/cpu/#/msr not opened "
 		      "energy data cannot be collected.", __func__);
 		_send_drain_request();
-		return;
+		return SLURM_ERROR;
 	}
 
 	/*
@@ -348,9 +353,71 @@ static void _get_joules_task(acct_gather_energy_t *energy)
 	for (i = 0; i < nb_pkg; i++)
 		result += _get_package_energy(i) + _get_dram_energy(i);
 
-	ret = (double)result * energy_units;
+	*joules = (double)result * energy_units;
 
-	log_flag(ENERGY, "RAPL Result %"PRIu64" = %.6f Joules", result, ret);
+	log_flag(ENERGY, "RAPL Result %"PRIu64" = %.6f Joules",
+		 result, *joules);
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Get the node's total energy from slurmd, which reads it again only if its
+ * last reading is older than delta seconds.
+ */
+static int _get_slurmd_joules(uint16_t delta, double *joules)
+{
+	acct_gather_energy_t *energies = NULL;
+	uint16_t sensor_cnt = 0;
+	int rc = SLURM_SUCCESS;
+
+	xassert(context_id != -1);
+
+	if (slurm_get_node_energy(conf->node_name, context_id, delta,
+				  &sensor_cnt, &energies)) {
+		error("%s: can't get info from slurmd", __func__);
+		return SLURM_ERROR;
+	}
+
+	if (sensor_cnt != 1) {
+		error("%s: received %u sensors, 1 expected",
+		      __func__, sensor_cnt);
+		rc = SLURM_ERROR;
+	} else if (energies->current_watts == NO_VAL) {
+		/* slurmd found no RAPL support, stop asking */
+		local_energy->current_watts = NO_VAL;
+		rc = SLURM_ERROR;
+	} else {
+		/* slurmd keeps the raw total of its last reading here */
+		*joules = (double)energies->previous_consumed_energy;
+	}
+
+	acct_gather_energy_destroy(energies);
+	return rc;
+}
+
+static void _get_joules_task(acct_gather_energy_t *energy, uint16_t delta)
+{
+	double ret;
+	static uint32_t readings = 0;
+
+	if (running_in_slurmd()) {
+		if (_read_joules(&ret) != SLURM_SUCCESS)
+			return;
+	} else if (_get_slurmd_joules(delta, &ret) != SLURM_SUCCESS) {
+		if (local_energy->current_watts == NO_VAL)
+			energy->consumed_energy = NO_VAL64;
+		return;
+	} else if (energy->consumed_energy &&
+		   ((uint64_t)ret < energy->previous_consumed_energy)) {
+		/*
+		 * slurmd was restarted while the step is alive and lost
+		 * count of counter wraparounds, continue from here.
+		 */
+		energy->base_consumed_energy =
+			(uint64_t)ret - energy->consumed_energy;
+		energy->previous_consumed_energy = (uint64_t)ret;
+	}
 
 	if (energy->consumed_energy) {
 		time_t interval;
@@ -446,7 +513,7 @@ extern int acct_gather_energy_p_update_node_energy(void)
 	if (local_energy->current_watts == NO_VAL)
 		return rc;
 
-	_get_joules_task(local_energy);
+	_get_joules_task(local_energy, 0);
 
 	return rc;
 }
@@ -509,10 +576,21 @@ extern int acct_gather_energy_p_get_data(enum acct_energy_type data_type,
 	switch (data_type) {
 	case ENERGY_DATA_JOULES_TASK:
 	case ENERGY_DATA_NODE_ENERGY_UP:
-		if (local_energy->current_watts == NO_VAL)
+		if (running_in_slurmd()) {
+			/*
+			 * slurmd keeps the only reading of the counters,
+			 * steps and the controller are all served from it.
+			 */
+			if (local_energy->current_watts != NO_VAL)
+				_get_joules_task(local_energy, 0);
+			memcpy(energy, local_energy,
+			       sizeof(acct_gather_energy_t));
+			if (local_energy->current_watts == NO_VAL)
+				energy->consumed_energy = NO_VAL64;
+		} else if (local_energy->current_watts == NO_VAL)
 			energy->consumed_energy = NO_VAL64;
 		else
-			_get_joules_task(energy);
+			_get_joules_task(energy, 10);
 		break;
 	case ENERGY_DATA_STRUCT:
 	case ENERGY_DATA_NODE_ENERGY:
@@ -537,6 +615,7 @@ extern int acct_gather_energy_p_set_data(enum acct_energy_type data_type,
 					 void *data)
 {
 	int rc = SLURM_SUCCESS;
+	int *delta = (int *)data;
 
 	xassert(running_in_slurmd_stepd());
 
@@ -544,7 +623,7 @@ extern int acct_gather_energy_p_set_data(enum acct_energy_type data_type,
 	case ENERGY_DATA_RECONFIG:
 		break;
 	case ENERGY_DATA_PROFILE:
-		_get_joules_task(local_energy);
+		_get_joules_task(local_energy, *delta);
 		_send_profile();
 		break;
 	case ENERGY_DATA_STEP_PTR:
@@ -579,12 +658,19 @@ extern void acct_gather_energy_p_conf_set(int context_id_in,
 	if (local_energy)
 		return;
 
+	context_id = context_id_in;
+	local_energy = acct_gather_energy_alloc(1);
+
+	/* Steps get their readings from slurmd */
+	if (!running_in_slurmd()) {
+		debug("%s loaded", plugin_name);
+		return;
+	}
+
 	_hardware();
 	for (i = 0; i < nb_pkg; i++)
 		pkg_fd[i] = _open_msr(pkg2cpu[i]);
 
-	local_energy = acct_gather_energy_alloc(1);
-
 	result = _read_msr(pkg_fd[0], MSR_RAPL_POWER_UNIT);
 	if (result == 0)
 		local_energy->current_watts = NO_VAL;
@@ -67,11 +67,12 @@
 #include "src/slurmd/common/privileges.h"
 #include "hdf5_api.h"
 
+/* Default number of records per chunk, see ProfileHDF5ChunkSize */
 #define HDF5_CHUNK_SIZE 10
+#define HDF5_CHUNK_SIZE_MAX 65536
 /* Compression level, a value of 0 through 9. Level 0 is faster but offers the
  * least compression; level 9 is slower but offers maximum compression.
  * A setting of -1 indicates that no compression is desired. */
-/* TODO: Make this configurable with a parameter */
 #define HDF5_COMPRESS 0
 
 /*
@@ -104,6 +105,8 @@ const char plugin_type[] = "acct_gather_profile/hdf5";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 typedef struct {
+	uint32_t chunk_size;
+	int compress;
 	char *dir;
 	uint32_t def;
 } slurm_hdf5_conf_t;
@@ -137,6 +140,8 @@ static size_t   tables_cur_len = 0;
 
 static void _reset_slurm_profile_conf(void)
 {
+	hdf5_conf.chunk_size = HDF5_CHUNK_SIZE;
+	hdf5_conf.compress = HDF5_COMPRESS;
 	xfree(hdf5_conf.dir);
 	hdf5_conf.def = ACCT_GATHER_PROFILE_NONE;
 }
@@ -250,6 +255,8 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 					       int *full_options_cnt)
 {
 	s_p_options_t options[] = {
+		{"ProfileHDF5ChunkSize", S_P_UINT32},
+		{"ProfileHDF5Compression", S_P_LONG},
 		{"ProfileHDF5Dir", S_P_STRING},
 		{"ProfileHDF5Default", S_P_STRING},
 		{NULL} };
@@ -261,10 +268,25 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 extern void acct_gather_profile_p_conf_set(s_p_hashtbl_t *tbl)
 {
 	char *tmp = NULL;
+	long compress;
+
 	_reset_slurm_profile_conf();
 	if (tbl) {
 		s_p_get_string(&hdf5_conf.dir, "ProfileHDF5Dir", tbl);
 
+		if (s_p_get_uint32(&hdf5_conf.chunk_size,
+				   "ProfileHDF5ChunkSize", tbl) &&
+		    (!hdf5_conf.chunk_size ||
+		     (hdf5_conf.chunk_size > HDF5_CHUNK_SIZE_MAX)))
+			fatal("ProfileHDF5ChunkSize must be between 1 and %d",
+			      HDF5_CHUNK_SIZE_MAX);
+
+		if (s_p_get_long(&compress, "ProfileHDF5Compression", tbl)) {
+			if ((compress < -1) || (compress > 9))
+				fatal("ProfileHDF5Compression must be between -1 and 9");
+			hdf5_conf.compress = compress;
+		}
+
 		if (s_p_get_string(&tmp, "ProfileHDF5Default", tbl)) {
 			hdf5_conf.def = acct_gather_profile_from_string(tmp);
 			if (hdf5_conf.def == ACCT_GATHER_PROFILE_NOT_SET) {
@@ -570,8 +592,8 @@ extern int acct_gather_profile_p_create_dataset(
 	/* create the table */
 	if (parent < 0)
 		parent = gid_node; /* default parent is the node group */
-	table_id = H5PTcreate_fl(parent, name, dtype_id, HDF5_CHUNK_SIZE,
-	                         HDF5_COMPRESS);
+	table_id = H5PTcreate_fl(parent, name, dtype_id, hdf5_conf.chunk_size,
+				 hdf5_conf.compress);
 	if (table_id < 0) {
 		error("PROFILE: Impossible to create the table %s", name);
 		H5Tclose(dtype_id);
@@ -646,6 +668,16 @@ extern void acct_gather_profile_p_conf_values(List *data)
 
 	xassert(*data);
 
+	key_pair = xmalloc(sizeof(config_key_pair_t));
+	key_pair->name = xstrdup("ProfileHDF5ChunkSize");
+	key_pair->value = xstrdup_printf("%u", hdf5_conf.chunk_size);
+	list_append(*data, key_pair);
+
+	key_pair = xmalloc(sizeof(config_key_pair_t));
+	key_pair->name = xstrdup("ProfileHDF5Compression");
+	key_pair->value = xstrdup_printf("%d", hdf5_conf.compress);
+	list_append(*data, key_pair);
+
 	key_pair = xmalloc(sizeof(config_key_pair_t));
 	key_pair->name = xstrdup("ProfileHDF5Dir");
 	key_pair->value = xstrdup(hdf5_conf.dir);
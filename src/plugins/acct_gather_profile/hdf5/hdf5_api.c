@@ -57,30 +57,21 @@ extern void profile_fini(void)
 
 extern hid_t get_attribute_handle(hid_t parent, char *name)
 {
-	char buf[MAX_ATTR_NAME+1];
-	int nattr, i, len;
 	hid_t aid;
-	H5O_info_t object_info;
 
 	if (parent < 0) {
 		debug3("PROFILE: parent is not HDF5 object");
 		return -1;
 	}
 
-	H5Oget_info(parent, &object_info);
-	nattr = object_info.num_attrs;
-	for (i = 0; (nattr>0) && (i<nattr); i++) {
-		aid = H5Aopen_by_idx(parent, ".", H5_INDEX_NAME, H5_ITER_INC,
-				     i, H5P_DEFAULT, H5P_DEFAULT);
-		// Get the name of the attribute.
-		len = H5Aget_name(aid, MAX_ATTR_NAME, buf);
-		if (len < MAX_ATTR_NAME) {
-			if (xstrcmp(buf, name) == 0) {
-				return aid;
-			}
-		}
-		H5Aclose(aid);
-	}
+	/*
+	 * Look the attribute up by name instead of walking every attribute
+	 * by index, which is quadratic on objects with many attributes.
+	 */
+	if ((strlen(name) < MAX_ATTR_NAME) && (H5Aexists(parent, name) > 0) &&
+	    ((aid = H5Aopen(parent, name, H5P_DEFAULT)) >= 0))
+		return aid;
+
 	debug3("PROFILE: failed to find HDF5 attribute=%s\n", name);
 
 	return -1;
@@ -88,35 +79,27 @@ extern hid_t get_attribute_handle(hid_t parent, char *name)
 
 extern hid_t get_group(hid_t parent, const char *name)
 {
-	char buf[MAX_GROUP_NAME];
-	hsize_t nobj;
 	hid_t gid;
-	int i, len;
-	H5G_info_t group_info;
 
 	if (parent < 0) {
 		debug3("PROFILE: parent is not HDF5 object");
 		return -1;
 	}
-	H5Gget_info(parent, &group_info);
-	nobj = group_info.nlinks;
-	for (i = 0; (nobj>0) && (i<nobj); i++) {
-		// Get the name of the group.
-		len = H5Lget_name_by_idx(parent, ".", H5_INDEX_NAME,
-					 H5_ITER_INC, i, buf, MAX_GROUP_NAME,
-					 H5P_DEFAULT);
-		if ((len > 0) && (len < MAX_GROUP_NAME)) {
-			if (xstrcmp(buf, name) == 0) {
-				gid = H5Gopen(parent, name, H5P_DEFAULT);
-				if (gid < 0)
-					error("PROFILE: Failed to open %s",
-					      name);
-				return gid;
-			}
-		}
-	}
 
-	return -1;
+	/*
+	 * Only direct children are matched. Look the link up by name rather
+	 * than iterating the whole group, as merged job files hold one link
+	 * per node and sh5util calls this for every node-step file.
+	 */
+	if (strchr(name, '/') || (strlen(name) >= MAX_GROUP_NAME) ||
+	    (H5Lexists(parent, name, H5P_DEFAULT) <= 0))
+		return -1;
+
+	gid = H5Gopen(parent, name, H5P_DEFAULT);
+	if (gid < 0)
+		error("PROFILE: Failed to open %s", name);
+
+	return gid;
 }
 
 extern hid_t make_group(hid_t parent, const char *name)
@@ -216,6 +216,10 @@ extern void bb_clear_config(bb_config_t *config_ptr, bool fini)
 	xfree(config_ptr->get_sys_state);
 	xfree(config_ptr->get_sys_status);
 	config_ptr->granularity = 1;
+	config_ptr->max_pre_run = 0;
+	config_ptr->max_stage_in = 0;
+	config_ptr->max_stage_out = 0;
+	config_ptr->max_teardown = 0;
 	if (fini) {
 		for (i = 0; i < config_ptr->pool_cnt; i++)
 			xfree(config_ptr->pool_ptr[i].name);
@@ -523,6 +527,10 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 		{"GetSysState", S_P_STRING},
 		{"GetSysStatus", S_P_STRING},
 		{"Granularity", S_P_STRING},
+		{"MaxPreRun", S_P_UINT32},
+		{"MaxStageIn", S_P_UINT32},
+		{"MaxStageOut", S_P_UINT32},
+		{"MaxTeardown", S_P_UINT32},
 		{"OtherTimeout", S_P_UINT32},
 		{"Pools", S_P_STRING},
 		{"StageInTimeout", S_P_UINT32},
@@ -652,6 +660,14 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 		xfree(tmp);
 	}
 
+	(void) s_p_get_uint32(&state_ptr->bb_config.max_pre_run,
+			      "MaxPreRun", bb_hashtbl);
+	(void) s_p_get_uint32(&state_ptr->bb_config.max_stage_in,
+			      "MaxStageIn", bb_hashtbl);
+	(void) s_p_get_uint32(&state_ptr->bb_config.max_stage_out,
+			      "MaxStageOut", bb_hashtbl);
+	(void) s_p_get_uint32(&state_ptr->bb_config.max_teardown,
+			      "MaxTeardown", bb_hashtbl);
 	(void) s_p_get_uint32(&state_ptr->bb_config.other_timeout,
 			     "OtherTimeout", bb_hashtbl);
 	(void) s_p_get_uint32(&state_ptr->bb_config.stage_in_timeout,
@@ -695,6 +711,14 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 		     state_ptr->bb_config.get_sys_status);
 		info("%s: Granularity:%"PRIu64"",  __func__,
 		     state_ptr->bb_config.granularity);
+		info("%s: MaxPreRun:%u", __func__,
+		     state_ptr->bb_config.max_pre_run);
+		info("%s: MaxStageIn:%u", __func__,
+		     state_ptr->bb_config.max_stage_in);
+		info("%s: MaxStageOut:%u", __func__,
+		     state_ptr->bb_config.max_stage_out);
+		info("%s: MaxTeardown:%u", __func__,
+		     state_ptr->bb_config.max_teardown);
 		for (i = 0; i < state_ptr->bb_config.pool_cnt; i++) {
 			info("%s: Pool[%d]:%s:%"PRIu64"", __func__, i,
 			     state_ptr->bb_config.pool_ptr[i].name,
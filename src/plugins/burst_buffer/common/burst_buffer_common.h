@@ -74,6 +74,10 @@ typedef struct bb_config {
 	char    *get_sys_status;
 	uint64_t granularity;		/* space allocation granularity,
 					 * units are GB */
+	uint32_t max_pre_run;		/* Concurrent API calls per stage, */
+	uint32_t max_stage_in;		/* 0 selects the plugin default */
+	uint32_t max_stage_out;
+	uint32_t max_teardown;
 	uint32_t pool_cnt;		/* Count of records in pool_ptr */
 	burst_buffer_pool_t *pool_ptr;	/* Type is defined in slurm.h */
 	uint32_t other_timeout;
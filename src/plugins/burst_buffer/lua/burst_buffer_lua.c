@@ -76,9 +76,22 @@
  * per "stage" (stage in, pre run, stage out, teardown) so that if we hit the
  * maximum in stage in (for example) we won't block all jobs from completing.
  * We also do this so that if 1000+ jobs complete or get cancelled all at
- * once they won't all run teardown at the same time.
+ * once they won't all run teardown at the same time. The per stage limits can
+ * be changed with MaxStageIn, MaxPreRun, MaxStageOut and MaxTeardown in
+ * burst_buffer.conf.
  */
 #define MAX_BURST_BUFFERS_PER_STAGE 128
+/*
+ * Stage-in may allocate buffers for up to this many times MaxStageIn jobs.
+ * Jobs beyond MaxStageIn wait in the stage-in queue and start in order of
+ * expected start time as running stage-ins complete.
+ */
+#define STAGE_IN_PREFETCH_FACTOR 2
+/* Maximum number of idle lua states kept for reuse by _start_lua_script() */
+#define MAX_LUA_STATE_POOL 16
+/* Registry keys used to reset a lua state before it is reused */
+#define LUA_SAVED_GLOBALS "_bb_saved_globals"
+#define LUA_JOB_INFO_META "_bb_job_info_meta"
 
 /*
  * These variables are required by the burst buffer plugin interface.  If they
@@ -162,6 +175,7 @@ typedef struct {
 	uint32_t job_id;
 	char *job_script;
 	char *pool;
+	time_t start_time;
 	uint32_t uid;
 } stage_in_args_t;
 
@@ -203,25 +217,67 @@ static int lua_thread_cnt = 0;
 pthread_mutex_t lua_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /*
- * Count of burst buffer API calls in each stage.
- * These variables are protected by stage_cnt_mutex.
+ * Burst buffer API calls in each stage are started through a queue. While the
+ * stage has fewer than max running calls, the waiter at the head of its queue
+ * is admitted and woken through its own condition variable. Stage-in waiters
+ * are ordered by the job's expected start time, jobs without one last. All
+ * other stages run in arrival order.
+ * These variables are protected by stage_mutex.
  */
-#define DEF_STAGE_THROTTLE \
-	static pthread_mutex_t stage_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;\
-	static pthread_cond_t stage_cnt_cond = PTHREAD_COND_INITIALIZER;\
-	static int stage_cnt = 0;
+typedef enum {
+	BB_STAGE_IN,
+	BB_STAGE_PRE_RUN,
+	BB_STAGE_OUT,
+	BB_STAGE_TEARDOWN,
+	BB_STAGE_CNT
+} bb_stage_t;
+
+typedef struct {
+	pthread_cond_t cond;
+	bool granted;		/* admitted by _stage_dispatch() */
+	time_t prio;		/* 0 runs after all other priorities */
+	uint64_t seq;
+} stage_waiter_t;
+
+typedef struct {
+	const char *name;
+	int running;
+	List waiters;		/* stage_waiter_t, in run order */
+	uint64_t seq;
+	uint32_t max;
+	uint64_t started;	/* Metrics, reported with DebugFlags */
+	uint64_t wait_usec;
+	uint64_t max_wait_usec;
+} stage_queue_t;
+
+static pthread_mutex_t stage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static stage_queue_t stage_queue[BB_STAGE_CNT] = {
+	[BB_STAGE_IN] = { .name = "stage_in" },
+	[BB_STAGE_PRE_RUN] = { .name = "pre_run" },
+	[BB_STAGE_OUT] = { .name = "stage_out" },
+	[BB_STAGE_TEARDOWN] = { .name = "teardown" },
+};
 
 /*
- * stage throttle doesn't guarantee the order each thread will start. For
- * stage_in we need to run burst_buffer.lua in job priority order so that
- * highest priority jobs can start as soon as possible. With this we only queue
- * up to MAX_BURST_BUFFERS_PER_STAGE _start_stage_in threads at once, so we
- * don't use stage throttle for stage_in.
- * This variable is protected by bb_state.bb_mutex.
+ * Count of jobs with an allocated burst buffer that have not completed
+ * stage-in, either running or waiting in the stage-in queue.
+ * This variable is protected by stage_in_mutex.
  */
 static pthread_mutex_t stage_in_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int stage_in_cnt = 0;
 
+/*
+ * Idle lua states, already loaded with burst_buffer.lua. Protected by
+ * lua_pool_mutex.
+ */
+typedef struct {
+	lua_State *L;
+	time_t load_time;
+} lua_pool_ent_t;
+
+static List lua_state_pool = NULL;
+static pthread_mutex_t lua_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* Function prototypes */
 static bb_job_t *_get_bb_job(job_record_t *job_ptr);
 static void _queue_teardown(uint32_t job_id, uint32_t user_id, bool hurry,
@@ -277,27 +333,165 @@ static void _decr_lua_thread_cnt(void)
 	slurm_mutex_unlock(&lua_thread_mutex);
 }
 
-static void _stage_throttle_start(pthread_mutex_t *mutex, pthread_cond_t *cond,
-				  int *cnt)
+static uint32_t _stage_limit(uint32_t max)
 {
-	slurm_mutex_lock(mutex);
-	while (1) {
-		if (*cnt < MAX_BURST_BUFFERS_PER_STAGE) {
-			*cnt = *cnt + 1;
+	return max ? max : MAX_BURST_BUFFERS_PER_STAGE;
+}
+
+/* Admit waiters from the head of the queue. Call with stage_mutex. */
+static void _stage_dispatch(stage_queue_t *queue)
+{
+	stage_waiter_t *waiter;
+
+	while ((queue->running < queue->max) && queue->waiters &&
+	       (waiter = list_pop(queue->waiters))) {
+		queue->running++;
+		waiter->granted = true;
+		slurm_cond_signal(&waiter->cond);
+	}
+}
+
+/* Copy the per stage limits from bb_state.bb_config. Call with bb_mutex. */
+static void _set_stage_limits(void)
+{
+	slurm_mutex_lock(&stage_mutex);
+	stage_queue[BB_STAGE_IN].max =
+		_stage_limit(bb_state.bb_config.max_stage_in);
+	stage_queue[BB_STAGE_PRE_RUN].max =
+		_stage_limit(bb_state.bb_config.max_pre_run);
+	stage_queue[BB_STAGE_OUT].max =
+		_stage_limit(bb_state.bb_config.max_stage_out);
+	stage_queue[BB_STAGE_TEARDOWN].max =
+		_stage_limit(bb_state.bb_config.max_teardown);
+	/* New limits may allow waiting threads to run */
+	for (int i = 0; i < BB_STAGE_CNT; i++)
+		_stage_dispatch(&stage_queue[i]);
+	slurm_mutex_unlock(&stage_mutex);
+}
+
+/* Maximum count of jobs which may be allocated a buffer for stage-in */
+static int _get_stage_in_limit(void)
+{
+	int limit;
+
+	slurm_mutex_lock(&stage_mutex);
+	limit = stage_queue[BB_STAGE_IN].max * STAGE_IN_PREFETCH_FACTOR;
+	slurm_mutex_unlock(&stage_mutex);
+
+	return limit;
+}
+
+/* Return true if waiter w1 runs before w2 */
+static bool _stage_waiter_before(stage_waiter_t *w1, stage_waiter_t *w2)
+{
+	if (w1->prio == w2->prio)
+		return (w1->seq < w2->seq);
+	if (!w1->prio)
+		return false;
+	if (!w2->prio)
+		return true;
+	return (w1->prio < w2->prio);
+}
+
+/* Insert a waiter in run order. Call with stage_mutex. */
+static void _stage_waiter_insert(stage_queue_t *queue, stage_waiter_t *waiter)
+{
+	list_itr_t *iter;
+	stage_waiter_t *next;
+
+	/* Arrival order or no expected start time, always last */
+	if (!waiter->prio) {
+		list_append(queue->waiters, waiter);
+		return;
+	}
+
+	iter = list_iterator_create(queue->waiters);
+	while ((next = list_next(iter))) {
+		if (_stage_waiter_before(waiter, next))
 			break;
-		}
-		slurm_cond_wait(cond, mutex);
 	}
-	slurm_mutex_unlock(mutex);
+	/* Inserts before next, or at the end of the list */
+	list_insert(iter, waiter);
+	list_iterator_destroy(iter);
+}
+
+/*
+ * Wait until this thread may run a burst buffer API call for the given stage.
+ * prio IN - expected job start time, smaller values run first and 0 runs last.
+ *	     Equal values run in arrival order.
+ */
+static void _stage_throttle_start(bb_stage_t stage, time_t prio)
+{
+	stage_queue_t *queue = &stage_queue[stage];
+	stage_waiter_t waiter = { .prio = prio };
+	uint64_t wait_usec;
+	DEF_TIMERS;
+
+	START_TIMER;
+	slurm_cond_init(&waiter.cond, NULL);
+	slurm_mutex_lock(&stage_mutex);
+	if (!queue->waiters)
+		queue->waiters = list_create(NULL);
+	waiter.seq = queue->seq++;
+	_stage_waiter_insert(queue, &waiter);
+	_stage_dispatch(queue);
+	while (!waiter.granted)
+		slurm_cond_wait(&waiter.cond, &stage_mutex);
+	END_TIMER;
+	wait_usec = DELTA_TIMER;
+	queue->started++;
+	queue->wait_usec += wait_usec;
+	if (wait_usec > queue->max_wait_usec)
+		queue->max_wait_usec = wait_usec;
+	slurm_mutex_unlock(&stage_mutex);
+	slurm_cond_destroy(&waiter.cond);
+}
+
+static void _stage_throttle_fini(bb_stage_t stage)
+{
+	slurm_mutex_lock(&stage_mutex);
+	stage_queue[stage].running--;
+	_stage_dispatch(&stage_queue[stage]);
+	slurm_mutex_unlock(&stage_mutex);
+}
+
+/* Log stage queue metrics, only while there is or has been activity */
+static void _log_stage_metrics(void)
+{
+	static uint64_t last_started[BB_STAGE_CNT];
+
+	if (!(slurm_conf.debug_flags & DEBUG_FLAG_BURST_BUF))
+		return;
+
+	slurm_mutex_lock(&stage_mutex);
+	for (int i = 0; i < BB_STAGE_CNT; i++) {
+		stage_queue_t *queue = &stage_queue[i];
+		int waiting = queue->waiters ? list_count(queue->waiters) : 0;
+
+		if (!queue->running && !waiting &&
+		    (queue->started == last_started[i]))
+			continue;
+		last_started[i] = queue->started;
+		log_flag(BURST_BUF, "%s: running=%d/%u waiting=%d started=%"PRIu64" avg_wait=%"PRIu64"usec max_wait=%"PRIu64"usec",
+			 queue->name, queue->running, queue->max, waiting,
+			 queue->started,
+			 queue->started ?
+			 (queue->wait_usec / queue->started) : 0,
+			 queue->max_wait_usec);
+	}
+	slurm_mutex_unlock(&stage_mutex);
 }
 
-static void _stage_throttle_fini(pthread_mutex_t *mutex, pthread_cond_t *cond,
-				 int *cnt)
+static void _stage_queue_fini(void)
 {
-	slurm_mutex_lock(mutex);
-	*cnt = *cnt - 1;
-	slurm_cond_broadcast(cond);
-	slurm_mutex_unlock(mutex);
+	slurm_mutex_lock(&stage_mutex);
+	for (int i = 0; i < BB_STAGE_CNT; i++) {
+		/* Detached threads may still be waiting at shutdown */
+		if (stage_queue[i].waiters &&
+		    !list_count(stage_queue[i].waiters))
+			FREE_NULL_LIST(stage_queue[i].waiters);
+	}
+	slurm_mutex_unlock(&stage_mutex);
 }
 
 static int _job_info_to_string(lua_State *L)
@@ -859,31 +1053,150 @@ static int _handle_lua_return(lua_State *L, const char *lua_func,
 	return rc;
 }
 
+static void _lua_pool_ent_destroy(void *x)
+{
+	lua_pool_ent_t *ent = x;
+
+	if (!ent)
+		return;
+	if (ent->L)
+		lua_close(ent->L);
+	xfree(ent);
+}
+
+static void _push_global_table(lua_State *L)
+{
+#if LUA_VERSION_NUM == 501
+	lua_pushvalue(L, LUA_GLOBALSINDEX);
+#else
+	lua_pushglobaltable(L);
+#endif
+}
+
+/* Save a copy of the globals of a freshly loaded script */
+static void _save_lua_globals(lua_State *L)
+{
+	lua_newtable(L);
+	_push_global_table(L);
+	lua_pushnil(L);
+	while (lua_next(L, -2)) {
+		/* Stack: copy, globals, key, value */
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, -5);
+	}
+	lua_pop(L, 1);
+	lua_setfield(L, LUA_REGISTRYINDEX, LUA_SAVED_GLOBALS);
+}
+
+/*
+ * Undo what the last call left behind before a lua state is reused: remove
+ * globals that it added, restore globals that it replaced, and stop the
+ * job_info table it was passed from referencing the freed job_info.
+ */
+static void _reset_lua_state(lua_State *L)
+{
+	lua_settop(L, 0);
+
+	lua_getfield(L, LUA_REGISTRYINDEX, LUA_JOB_INFO_META);
+	if (lua_istable(L, -1)) {
+		lua_pushnil(L);
+		lua_setfield(L, -2, "_job_info_ptr");
+	}
+	lua_pop(L, 1);
+	lua_pushnil(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, LUA_JOB_INFO_META);
+
+	lua_getfield(L, LUA_REGISTRYINDEX, LUA_SAVED_GLOBALS);
+	_push_global_table(L);
+	lua_pushnil(L);
+	while (lua_next(L, -2)) {
+		/* Stack: saved, globals, key, value */
+		lua_pop(L, 1);
+		lua_pushvalue(L, -1);
+		lua_rawget(L, -4);
+		if (lua_isnil(L, -1)) {
+			/* Clearing an existing field is safe in lua_next() */
+			lua_pushvalue(L, -2);
+			lua_pushnil(L);
+			lua_rawset(L, -5);
+		}
+		lua_pop(L, 1);
+	}
+	lua_pushnil(L);
+	while (lua_next(L, -3)) {
+		/* Stack: saved, globals, key, value */
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, -4);
+	}
+	lua_pop(L, 2);
+}
+
+/*
+ * Take an idle lua state from the pool, or a new empty entry if none is
+ * available. slurm_lua_loadscript() (re)loads the script as needed.
+ */
+static lua_pool_ent_t *_lua_pool_get(void)
+{
+	lua_pool_ent_t *ent = NULL;
+
+	slurm_mutex_lock(&lua_pool_mutex);
+	if (lua_state_pool)
+		ent = list_pop(lua_state_pool);
+	slurm_mutex_unlock(&lua_pool_mutex);
+
+	if (!ent)
+		ent = xmalloc(sizeof(*ent));
+
+	return ent;
+}
+
+/* Return a lua state to the pool, closing it if the pool is full */
+static void _lua_pool_put(lua_pool_ent_t *ent)
+{
+	_reset_lua_state(ent->L);
+
+	slurm_mutex_lock(&lua_pool_mutex);
+	if (!lua_state_pool)
+		lua_state_pool = list_create(_lua_pool_ent_destroy);
+	if (list_count(lua_state_pool) < MAX_LUA_STATE_POOL) {
+		list_push(lua_state_pool, ent);
+		ent = NULL;
+	}
+	slurm_mutex_unlock(&lua_pool_mutex);
+
+	_lua_pool_ent_destroy(ent);
+}
+
 static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 			     char **argv, job_info_msg_t *job_info,
 			     char **resp_msg)
 {
 	/*
-	 * We don't make lua_State L or lua_script_last_loaded static.
-	 * If they were static, then only 1 thread could use them at a time.
-	 * This would be problematic for performance since these
-	 * calls can possibly last a long time. By not making them static it
-	 * means we can let these calls run in parallel, but it also means
-	 * we don't preserve the previous script. Therefore, we have to
-	 * reload the script every time even if the script hasn't changed.
-	 * Also, if there is ever a problem loading the script then we can't
-	 * fall back to the old script.
+	 * Each call takes its own lua_State from a pool so that calls,
+	 * which can possibly last a long time, run in parallel. States are
+	 * returned to the pool afterwards so that the script is only loaded
+	 * again when it has changed, rather than on every call. If loading
+	 * a changed script fails, the previously loaded script is used.
+	 * The globals are reset after each call, so a call does not see
+	 * globals set by an earlier one.
 	 */
-	lua_State *L = NULL;
-	time_t lua_script_last_loaded = (time_t) 0;
+	lua_pool_ent_t *ent = _lua_pool_get();
+	lua_State *L = ent->L;
 	int rc, i;
 
-	rc = slurm_lua_loadscript(&L, "burst_buffer/lua",
+	rc = slurm_lua_loadscript(&ent->L, "burst_buffer/lua",
 				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+				  &ent->load_time, _loadscript_extra);
 
-	if (rc != SLURM_SUCCESS)
+	if (rc != SLURM_SUCCESS) {
+		_lua_pool_ent_destroy(ent);
 		return rc;
+	}
+	if (ent->L != L)
+		_save_lua_globals(ent->L);
+	L = ent->L;
 
 	/*
 	 * All lua script functions should have been verified during
@@ -893,7 +1206,7 @@ static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 	if (lua_isnil(L, -1)) {
 		error("%s: Couldn't find function %s",
 		      __func__, func);
-		lua_close(L);
+		_lua_pool_put(ent);
 		return SLURM_ERROR;
 	}
 
@@ -902,6 +1215,9 @@ static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 	if (job_info) {
 		job_info_t *info = &job_info->job_array[0];
 		_push_job_info(info, L);
+		/* Remember the metatable to clear its pointer afterwards */
+		lua_getmetatable(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, LUA_JOB_INFO_META);
 		argc++;
 	}
 
@@ -917,7 +1233,7 @@ static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 		rc = _handle_lua_return(L, func, job_id, resp_msg);
 	}
 	slurm_lua_stack_dump("burst_buffer/lua", "after lua_pcall, after returns have been popped", L);
-	lua_close(L);
+	_lua_pool_put(ent);
 
 	return rc;
 }
@@ -1565,8 +1881,7 @@ static void *_start_stage_out(void *x)
 	bb_job_t *bb_job = NULL;
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_start(BB_STAGE_OUT, 0);
 
 	argc = 4;
 	argv = xcalloc(argc + 1, sizeof(char *)); /* NULL-terminated */
@@ -1705,7 +2020,7 @@ static void *_start_stage_out(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_fini(BB_STAGE_OUT);
 	xfree(resp_msg);
 	xfree(stage_out_args->job_script);
 	xfree(stage_out_args);
@@ -1768,6 +2083,7 @@ static void *_bb_agent(void *args)
 			_load_state(false);	/* Has own locking */
 		}
 		_save_bb_state();	/* Has own locks excluding file write */
+		_log_stage_metrics();
 	}
 
 	/* Wait for lua threads to finish, then save state once more. */
@@ -2206,6 +2522,7 @@ extern int init(void)
 	slurm_mutex_lock(&bb_state.bb_mutex);
 	bb_load_config(&bb_state, (char *)plugin_type); /* Removes "const" */
 	_test_config();
+	_set_stage_limits();
 	log_flag(BURST_BUF, "");
 	bb_alloc_cache(&bb_state);
 	slurm_thread_create(&bb_state.bb_thread, _bb_agent, NULL);
@@ -2251,6 +2568,11 @@ extern int fini(void)
 	slurm_mutex_unlock(&bb_state.bb_mutex);
 
 	slurm_mutex_destroy(&lua_thread_mutex);
+	_stage_queue_fini();
+
+	slurm_mutex_lock(&lua_pool_mutex);
+	FREE_NULL_LIST(lua_state_pool);
+	slurm_mutex_unlock(&lua_pool_mutex);
 
 	slurm_lua_fini();
 	xfree(lua_script_path);
@@ -2540,6 +2862,7 @@ extern int bb_p_reconfig(void)
 	log_flag(BURST_BUF, "");
 	bb_load_config(&bb_state, (char *) plugin_type); /* Remove "const" */
 	_test_config();
+	_set_stage_limits();
 
 	/* reconfig is the place we make sure the pointers are correct */
 	for (int i = 0; i < BB_HASH_SIZE; i++) {
@@ -2995,8 +3318,7 @@ static void *_start_teardown(void *x)
 		NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_start(BB_STAGE_TEARDOWN, 0);
 
 	argc = 5;
 	argv = xcalloc(argc + 1, sizeof(char *)); /* NULL-terminated */
@@ -3116,7 +3438,7 @@ static void *_start_teardown(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_fini(BB_STAGE_TEARDOWN);
 	xfree(resp_msg);
 	xfree(teardown_args->job_script);
 	xfree(teardown_args);
@@ -3188,6 +3510,19 @@ static void *_start_stage_in(void *x)
 	argv[4] = xstrdup_printf("%"PRIu64, stage_in_args->bb_size);
 	argv[5] = xstrdup_printf("%s", stage_in_args->job_script);
 
+	_stage_throttle_start(BB_STAGE_IN, stage_in_args->start_time);
+
+	/* The job may have been cancelled while waiting in the queue */
+	slurm_mutex_lock(&bb_state.bb_mutex);
+	bb_job = bb_job_find(&bb_state, stage_in_args->job_id);
+	if (!bb_job || (bb_job->state != BB_STATE_STAGING_IN)) {
+		log_flag(BURST_BUF, "JobId=%u no longer staging in, skipping setup",
+			 stage_in_args->job_id);
+		slurm_mutex_unlock(&bb_state.bb_mutex);
+		goto fini;
+	}
+	slurm_mutex_unlock(&bb_state.bb_mutex);
+
 	timeout = bb_state.bb_config.other_timeout;
 	op = "slurm_bb_setup";
 
@@ -3403,6 +3738,7 @@ static void *_start_stage_in(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
+	_stage_throttle_fini(BB_STAGE_IN);
 	_decr_stage_in_cnt();
 	xfree(resp_msg);
 	xfree(stage_in_args->job_script);
@@ -3435,6 +3771,8 @@ static int _queue_stage_in(job_record_t *job_ptr, bb_job_t *bb_job)
 		stage_in_args->pool = NULL;
 	stage_in_args->bb_size = bb_job->total_size;
 	stage_in_args->job_script = bb_handle_job_script(job_ptr, bb_job);
+	/* Expected start time, as planned by the scheduler or backfill */
+	stage_in_args->start_time = job_ptr->start_time;
 
 	/*
 	 * Create bb allocation for the job now. Check if it has already been
@@ -3485,7 +3823,7 @@ static int _try_alloc_job_bb(void *x, void *arg)
 	else
 		rc = 0;
 
-	if (_get_stage_in_cnt() >= MAX_BURST_BUFFERS_PER_STAGE)
+	if (_get_stage_in_cnt() >= _get_stage_in_limit())
 		return SLURM_ERROR; /* Break out of loop */
 
 	if (rc == 0) {
@@ -3570,7 +3908,7 @@ extern int bb_p_job_test_stage_in(job_record_t *job_ptr, bool test_only)
 	} else if (bb_job->state < BB_STATE_STAGING_IN) {
 		/* Job buffer not allocated, create now if space available */
 		rc = -1;
-		if (stage_in_cnt >= MAX_BURST_BUFFERS_PER_STAGE)
+		if (_get_stage_in_cnt() >= _get_stage_in_limit())
 			goto fini;
 		if (test_only)
 			goto fini;
@@ -3712,8 +4050,7 @@ static void *_start_pre_run(void *x)
 	pre_run_args_t *pre_run_args = (pre_run_args_t *) x;
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_start(BB_STAGE_PRE_RUN, 0);
 
 	argc = 4;
 	argv = xcalloc(argc + 1, sizeof (char *)); /* NULL-terminated */
@@ -3808,7 +4145,7 @@ static void *_start_pre_run(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	_stage_throttle_fini(BB_STAGE_PRE_RUN);
 	xfree(resp_msg);
 	xfree(pre_run_args->job_script);
 	xfree(pre_run_args);
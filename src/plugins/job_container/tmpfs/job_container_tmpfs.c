@@ -47,7 +47,10 @@
 #include <sched.h>
 #include <fcntl.h>
 #include <sys/mount.h>
+#include <sys/file.h>
+#include <sys/vfs.h>
 #include <semaphore.h>
+#include <linux/magic.h>
 
 #include "src/common/slurm_xlator.h"
 
@@ -57,6 +60,7 @@
 #include "src/common/read_config.h"
 #include "src/common/run_command.h"
 #include "src/common/stepd_api.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -64,8 +68,21 @@
 
 #include "read_jcconf.h"
 
+#ifndef NSFS_MAGIC
+#define NSFS_MAGIC 0x6e736673
+#endif
+
+/*
+ * Namespace template under BasePath which job namespaces are copied from
+ * when NamespaceTemplate is set, and prefix of job directories waiting to
+ * be removed in the background.
+ */
+#define TEMPLATE_DIR ".template"
+#define TRASH_PREFIX ".trash."
+
 static int _create_ns(uint32_t job_id, stepd_step_rec_t *step);
 static int _delete_ns(uint32_t job_id);
+static void _remove_dir_background(char *path);
 
 #if defined (__APPLE__)
 extern slurmd_conf_t *conf __attribute__((weak_import));
@@ -233,9 +250,19 @@ extern int container_p_restore(char *dir_name, bool recover)
 
 	while ((ep = readdir(dp))) {
 		/* If possible, only check directories */
-		if ((ep->d_type == DT_DIR) || (ep->d_type == DT_UNKNOWN)) {
-			if (_restore_ns(steps, ep->d_name))
-				rc = SLURM_ERROR;
+		if ((ep->d_type != DT_DIR) && (ep->d_type != DT_UNKNOWN))
+			continue;
+		if (!xstrncmp(ep->d_name, TRASH_PREFIX,
+			      strlen(TRASH_PREFIX))) {
+			/* Left over from a background removal */
+			char *path = NULL;
+
+			xstrfmtcat(path, "%s/%s",
+				   jc_conf->basepath, ep->d_name);
+			_remove_dir_background(path);
+			xfree(path);
+		} else if (_restore_ns(steps, ep->d_name)) {
+			rc = SLURM_ERROR;
 		}
 	}
 	closedir(dp);
@@ -358,113 +385,50 @@ static int _clean_job_basepath(uint32_t job_id)
 	return SLURM_SUCCESS;
 }
 
-static int _create_ns(uint32_t job_id, stepd_step_rec_t *step)
+/* Set the propagation of the root filesystem in a new mount namespace */
+static int _set_root_propagation(void)
+{
+	if (!jc_conf->shared) {
+		/* Set root filesystem to private */
+		if (mount(NULL, "/", NULL, MS_PRIVATE|MS_REC, NULL)) {
+			error("%s: Failed to make root private: %m", __func__);
+			return -1;
+		}
+	} else {
+		/* Set root filesystem to shared */
+		if (mount(NULL, "/", NULL, MS_SHARED | MS_REC, NULL)) {
+			error("%s: Failed to make root shared: %m", __func__);
+			return -1;
+		}
+		/* Set root filesystem to slave */
+		if (mount(NULL, "/", NULL, MS_SLAVE | MS_REC, NULL)) {
+			error("%s: Failed to make root slave: %m", __func__);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Fork a child which creates a new mount namespace and hold the namespace
+ * active by bind mounting it on ns_holder. If tmpl_fd is valid, the new
+ * namespace is a copy of the namespace template it refers to. The child then
+ * calls setup() from inside the new namespace.
+ */
+static int _fork_ns(char *ns_holder, int tmpl_fd,
+		    int (*setup)(void *arg, bool from_template), void *arg)
 {
-	char *job_mount = NULL, *ns_holder = NULL, *src_bind = NULL;
-	char *result = NULL;
-	int fd;
 	int rc = 0;
 	sem_t *sem1 = NULL;
 	sem_t *sem2 = NULL;
 	pid_t cpid;
 
-	_create_paths(job_id, &job_mount, &ns_holder, &src_bind);
-
-	if (mkdir(job_mount, 0700)) {
-		error("%s: mkdir %s failed: %m", __func__, job_mount);
-		rc = SLURM_ERROR;
-		goto end_it;
-	}
-
-	/*
-	 * MS_BIND mountflag would make mount() ignore all other mountflags
-	 * except MS_REC. We need MS_PRIVATE mountflag as well to make the
-	 * mount (as well as all mounts inside it) private, which needs to be
-	 * done by calling mount() a second time with MS_PRIVATE and MS_REC
-	 * flags.
-	 */
-	if (mount(job_mount, job_mount, NULL, MS_BIND, NULL)) {
-		error("%s: Initial base mount failed: %m", __func__);
-		rc = SLURM_ERROR;
-		goto end_it;
-	}
-	if (mount(job_mount, job_mount, NULL, MS_PRIVATE | MS_REC, NULL)) {
-		error("%s: Initial base mount failed: %m", __func__);
-		rc = SLURM_ERROR;
-		goto end_it;
-	}
-
-	fd = open(ns_holder, O_CREAT|O_RDWR, S_IRWXU);
-	if (fd == -1) {
-		error("%s: open failed %s: %m", __func__, ns_holder);
-		rc = -1;
-		goto exit2;
-	}
-	close(fd);
-
-	/* run any initialization script- if any*/
-	if (jc_conf->initscript) {
-		run_command_args_t run_command_args = {
-			.max_wait = 10000,
-			.script_path = jc_conf->initscript,
-			.script_type = "initscript",
-			.status = &rc,
-		};
-		run_command_args.env = env_array_create();
-		if (step->het_job_id && (step->het_job_id != NO_VAL))
-			env_array_overwrite_fmt(&run_command_args.env,
-						"SLURM_HET_JOB_ID", "%u",
-						step->het_job_id);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_JOB_GID", "%u",
-					step->gid);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_JOB_ID", "%u", job_id);
-
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_JOB_MOUNTPOINT_SRC", "%s",
-					src_bind);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_JOB_UID", "%u",
-					step->uid);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_JOB_USER", "%s",
-					step->user_name);
-		if (step->cwd)
-			env_array_overwrite_fmt(&run_command_args.env,
-						"SLURM_JOB_WORK_DIR", "%s",
-						step->cwd);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURM_CONF", "%s",
-					slurm_conf.slurm_conf);
-		env_array_overwrite_fmt(&run_command_args.env,
-					"SLURMD_NODENAME", "%s",
-					conf->node_name);
-		result = run_command(&run_command_args);
-		env_array_free(run_command_args.env);
-		if (rc) {
-			error("%s: init script: %s failed",
-			      __func__, jc_conf->initscript);
-			xfree(result);
-			goto exit2;
-		} else {
-			log_flag(JOB_CONT, "initscript stdout: %s", result);
-		}
-		xfree(result);
-	}
-
-	rc = mkdir(src_bind, 0700);
-	if (rc && (errno != EEXIST)) {
-		error("%s: mkdir failed %s, %m", __func__, src_bind);
-		goto exit2;
-	}
-
 	sem1 = mmap(NULL, sizeof(*sem1), PROT_READ|PROT_WRITE,
 		    MAP_SHARED|MAP_ANONYMOUS, -1, 0);
 	if (sem1 == MAP_FAILED) {
 		error("%s: mmap failed: %m", __func__);
-		rc = -1;
-		goto exit2;
+		return -1;
 	}
 
 	sem2 = mmap(NULL, sizeof(*sem2), PROT_READ|PROT_WRITE,
@@ -473,8 +437,7 @@ static int _create_ns(uint32_t job_id, stepd_step_rec_t *step)
 		error("%s: mmap failed: %m", __func__);
 		sem_destroy(sem1);
 		munmap(sem1, sizeof(*sem1));
-		rc = -1;
-		goto exit2;
+		return -1;
 	}
 
 	rc = sem_init(sem1, 1, 0);
@@ -497,6 +460,19 @@ static int _create_ns(uint32_t job_id, stepd_step_rec_t *step)
 	}
 
 	if (cpid == 0) {
+		bool from_template = false;
+
+		/*
+		 * Enter the namespace template so that unshare() copies it
+		 * rather than the current namespace.
+		 */
+		if (tmpl_fd != -1) {
+			if (setns(tmpl_fd, CLONE_NEWNS))
+				error("%s: setns to namespace template failed, not using it: %m",
+				      __func__);
+			else
+				from_template = true;
+		}
 		rc = unshare(CLONE_NEWNS);
 		if (rc) {
 			error("%s: %m", __func__);
@@ -512,78 +488,15 @@ static int _create_ns(uint32_t job_id, stepd_step_rec_t *step)
 			rc = -1;
 			goto child_exit;
 		}
-		if (!jc_conf->shared) {
-			/* Set root filesystem to private */
-			if (mount(NULL, "/", NULL, MS_PRIVATE|MS_REC, NULL)) {
-				error("%s: Failed to make root private: %m",
-				      __func__);
-				rc = -1;
-				goto child_exit;
-			}
-		} else {
-			/* Set root filesystem to shared */
-			if (mount(NULL, "/", NULL, MS_SHARED | MS_REC, NULL)) {
-				error("%s: Failed to make root shared: %m",
-				      __func__);
-				rc = -1;
-				goto child_exit;
-			}
-			/* Set root filesystem to slave */
-			if (mount(NULL, "/", NULL, MS_SLAVE | MS_REC, NULL)) {
-				error("%s: Failed to make root slave: %m",
-				      __func__);
-				rc = -1;
-				goto child_exit;
-			}
-		}
-
-		/*
-		 * Now we have a persistent mount namespace.
-		 * Mount private directories inside the namespace.
-		 */
-		if (_mount_private_dirs(src_bind, step->uid) == -1) {
-			rc = -1;
-			goto child_exit;
-		}
-
-		/*
-		 * this happens when restarting the slurmd, the ownership should
-		 * already be correct here.
-		 */
-		rc = chown(src_bind, step->uid, -1);
-		if (rc) {
-			error("%s: chown failed for %s: %m",
-			      __func__, src_bind);
-			rc = -1;
-			goto child_exit;
-		}
 
-		/*
-		 * This umount is to remove the basepath mount from being
-		 * visible inside the namespace. So if a user looks up the
-		 * mounts inside the job, they will only see their job mount
-		 * but not the basepath mount.
-		 */
-		if (jc_conf->shared)
-			rc = _clean_job_basepath(job_id);
-		else
-			rc = umount2(job_mount, MNT_DETACH);
-		if (rc) {
-			error("%s: failed to clean job mount(s): %m", __func__);
-			goto child_exit;
-		}
+		/* Now we have a persistent mount namespace. */
+		rc = setup(arg, from_template);
 	child_exit:
 		sem_destroy(sem1);
 		munmap(sem1, sizeof(*sem1));
 		sem_destroy(sem2);
 		munmap(sem2, sizeof(*sem2));
 
-		if (!rc) {
-			rc = _mount_private_shm();
-			if (rc)
-				error("%s: could not mount private shm",
-				      __func__);
-		}
 		exit(rc);
 	} else {
 		int wstatus;
@@ -630,6 +543,343 @@ exit1:
 	sem_destroy(sem2);
 	munmap(sem2, sizeof(*sem2));
 
+	return rc;
+}
+
+/*
+ * Mount table of the current namespace, excluding anything under BasePath
+ * which changes with every job. Used to detect when the namespace template
+ * no longer matches the host. Caller must xfree the return value.
+ */
+static char *_get_mount_sig(void)
+{
+	FILE *fp;
+	char *line = NULL, *prefix = NULL, *sig = NULL;
+	size_t len = 0;
+
+	if (!(fp = fopen("/proc/self/mountinfo", "r"))) {
+		error("%s: fopen /proc/self/mountinfo failed: %m", __func__);
+		return NULL;
+	}
+
+	xstrfmtcat(prefix, " %s/", jc_conf->basepath);
+	while (getline(&line, &len, fp) != -1) {
+		if (!xstrstr(line, prefix))
+			xstrcat(sig, line);
+	}
+	free(line);
+	fclose(fp);
+	xfree(prefix);
+
+	return sig;
+}
+
+static bool _template_sig_match(char *sig_file, char *sig)
+{
+	buf_t *buf;
+	bool match;
+
+	if (!(buf = create_mmap_buf(sig_file)))
+		return false;
+	match = ((size_buf(buf) == strlen(sig)) &&
+		 !memcmp(get_buf_data(buf), sig, size_buf(buf)));
+	FREE_NULL_BUFFER(buf);
+
+	return match;
+}
+
+static int _setup_template_ns(void *arg, bool from_template)
+{
+	int rc;
+
+	if ((rc = _set_root_propagation()))
+		return rc;
+
+	/* Jobs copied from the template must not see the mounts of others */
+	return _clean_job_basepath(0);
+}
+
+static int _create_template_ns(char *tmpl_dir, char *tmpl_ns, char *sig_file,
+			       char *sig)
+{
+	int fd, rc;
+
+	/* Discard any previous template, jobs using it are unaffected */
+	(void) umount2(tmpl_dir, MNT_DETACH);
+
+	if (mkdir(tmpl_dir, 0700) && (errno != EEXIST)) {
+		error("%s: mkdir %s failed: %m", __func__, tmpl_dir);
+		return SLURM_ERROR;
+	}
+	/* See _create_ns() for why this is bind mounted as private */
+	if (mount(tmpl_dir, tmpl_dir, NULL, MS_BIND, NULL) ||
+	    mount(tmpl_dir, tmpl_dir, NULL, MS_PRIVATE | MS_REC, NULL)) {
+		error("%s: template base mount failed: %m", __func__);
+		return SLURM_ERROR;
+	}
+
+	fd = open(tmpl_ns, O_CREAT|O_RDWR, S_IRWXU);
+	if (fd == -1) {
+		error("%s: open failed %s: %m", __func__, tmpl_ns);
+		return SLURM_ERROR;
+	}
+	close(fd);
+
+	if ((rc = _fork_ns(tmpl_ns, -1, _setup_template_ns, NULL)))
+		return rc;
+
+	fd = open(sig_file, O_CREAT|O_WRONLY|O_TRUNC, S_IRUSR|S_IWUSR);
+	if (fd == -1) {
+		error("%s: open failed %s: %m", __func__, sig_file);
+		return SLURM_ERROR;
+	}
+	safe_write(fd, sig, strlen(sig));
+	close(fd);
+
+	log_flag(JOB_CONT, "created namespace template %s", tmpl_ns);
+
+	return SLURM_SUCCESS;
+
+rwfail:
+	error("%s: write failed %s: %m", __func__, sig_file);
+	close(fd);
+	(void) unlink(sig_file);
+	return SLURM_ERROR;
+}
+
+/*
+ * Return a file descriptor of the namespace template, creating or rebuilding
+ * the template first if needed. The template is rebuilt when Shared changes.
+ * A private template is also rebuilt when the host mounts change, a shared
+ * one receives them through propagation.
+ * RET fd or -1 if the template is not available.
+ */
+static int _get_template_fd(void)
+{
+	char *lock_file = NULL, *tmpl_dir = NULL, *tmpl_ns = NULL;
+	char *sig_file = NULL, *sig = NULL, *mount_sig = NULL;
+	int fd = -1, lock_fd;
+	struct statfs st;
+
+	xstrfmtcat(lock_file, "%s/%s.lock", jc_conf->basepath, TEMPLATE_DIR);
+	xstrfmtcat(tmpl_dir, "%s/%s", jc_conf->basepath, TEMPLATE_DIR);
+	xstrfmtcat(tmpl_ns, "%s/ns", tmpl_dir);
+	xstrfmtcat(sig_file, "%s/mounts", tmpl_dir);
+
+	/* Serialize template checks and rebuilds between jobs */
+	lock_fd = open(lock_file, O_CREAT|O_RDWR|O_CLOEXEC, S_IRUSR|S_IWUSR);
+	if (lock_fd == -1) {
+		error("%s: open failed %s: %m", __func__, lock_file);
+		goto end_it;
+	}
+	if (flock(lock_fd, LOCK_EX)) {
+		error("%s: flock failed %s: %m", __func__, lock_file);
+		goto end_it;
+	}
+
+	xstrfmtcat(sig, "Shared=%s\n", jc_conf->shared ? "yes" : "no");
+	if (!jc_conf->shared) {
+		if (!(mount_sig = _get_mount_sig()))
+			goto end_it;
+		xstrcat(sig, mount_sig);
+		xfree(mount_sig);
+	}
+
+	if ((fd = open(tmpl_ns, O_RDONLY|O_CLOEXEC)) != -1) {
+		if (fstatfs(fd, &st) || (st.f_type != NSFS_MAGIC) ||
+		    !_template_sig_match(sig_file, sig)) {
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	if ((fd == -1) &&
+	    !_create_template_ns(tmpl_dir, tmpl_ns, sig_file, sig)) {
+		if ((fd = open(tmpl_ns, O_RDONLY|O_CLOEXEC)) == -1)
+			error("%s: open failed %s: %m", __func__, tmpl_ns);
+	}
+
+end_it:
+	if (lock_fd != -1)
+		close(lock_fd);
+	xfree(lock_file);
+	xfree(tmpl_dir);
+	xfree(tmpl_ns);
+	xfree(sig_file);
+	xfree(sig);
+
+	return fd;
+}
+
+typedef struct {
+	uint32_t job_id;
+	char *job_mount;
+	char *src_bind;
+	uid_t uid;
+} job_ns_args_t;
+
+static int _setup_job_ns(void *arg, bool from_template)
+{
+	job_ns_args_t *args = arg;
+	int rc;
+
+	/* A namespace template already has the root propagation set */
+	if (!from_template && (rc = _set_root_propagation()))
+		return rc;
+
+	/* Mount private directories inside the namespace. */
+	if (_mount_private_dirs(args->src_bind, args->uid) == -1)
+		return -1;
+
+	/*
+	 * this happens when restarting the slurmd, the ownership should
+	 * already be correct here.
+	 */
+	rc = chown(args->src_bind, args->uid, -1);
+	if (rc) {
+		error("%s: chown failed for %s: %m",
+		      __func__, args->src_bind);
+		return -1;
+	}
+
+	/*
+	 * This umount is to remove the basepath mount from being
+	 * visible inside the namespace. So if a user looks up the
+	 * mounts inside the job, they will only see their job mount
+	 * but not the basepath mount. A private template was created
+	 * before this job mount and does not contain it.
+	 */
+	if (jc_conf->shared)
+		rc = _clean_job_basepath(args->job_id);
+	else if (!from_template)
+		rc = umount2(args->job_mount, MNT_DETACH);
+	if (rc) {
+		error("%s: failed to clean job mount(s): %m", __func__);
+		return rc;
+	}
+
+	rc = _mount_private_shm();
+	if (rc)
+		error("%s: could not mount private shm", __func__);
+
+	return rc;
+}
+
+static int _create_ns(uint32_t job_id, stepd_step_rec_t *step)
+{
+	char *job_mount = NULL, *ns_holder = NULL, *src_bind = NULL;
+	char *result = NULL;
+	int fd, tmpl_fd = -1;
+	int rc = 0;
+	bool from_template = false;
+	job_ns_args_t job_ns_args;
+	DEF_TIMERS;
+
+	START_TIMER;
+	_create_paths(job_id, &job_mount, &ns_holder, &src_bind);
+
+	if (mkdir(job_mount, 0700)) {
+		error("%s: mkdir %s failed: %m", __func__, job_mount);
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+
+	/*
+	 * MS_BIND mountflag would make mount() ignore all other mountflags
+	 * except MS_REC. We need MS_PRIVATE mountflag as well to make the
+	 * mount (as well as all mounts inside it) private, which needs to be
+	 * done by calling mount() a second time with MS_PRIVATE and MS_REC
+	 * flags.
+	 */
+	if (mount(job_mount, job_mount, NULL, MS_BIND, NULL)) {
+		error("%s: Initial base mount failed: %m", __func__);
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+	if (mount(job_mount, job_mount, NULL, MS_PRIVATE | MS_REC, NULL)) {
+		error("%s: Initial base mount failed: %m", __func__);
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+
+	fd = open(ns_holder, O_CREAT|O_RDWR, S_IRWXU);
+	if (fd == -1) {
+		error("%s: open failed %s: %m", __func__, ns_holder);
+		rc = -1;
+		goto exit2;
+	}
+	close(fd);
+
+	/* run any initialization script- if any*/
+	if (jc_conf->initscript) {
+		run_command_args_t run_command_args = {
+			.max_wait = 10000,
+			.script_path = jc_conf->initscript,
+			.script_type = "initscript",
+			.status = &rc,
+		};
+		run_command_args.env = env_array_create();
+		if (step->het_job_id && (step->het_job_id != NO_VAL))
+			env_array_overwrite_fmt(&run_command_args.env,
+						"SLURM_HET_JOB_ID", "%u",
+						step->het_job_id);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_JOB_GID", "%u",
+					step->gid);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_JOB_ID", "%u", job_id);
+
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_JOB_MOUNTPOINT_SRC", "%s",
+					src_bind);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_JOB_UID", "%u",
+					step->uid);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_JOB_USER", "%s",
+					step->user_name);
+		if (step->cwd)
+			env_array_overwrite_fmt(&run_command_args.env,
+						"SLURM_JOB_WORK_DIR", "%s",
+						step->cwd);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURM_CONF", "%s",
+					slurm_conf.slurm_conf);
+		env_array_overwrite_fmt(&run_command_args.env,
+					"SLURMD_NODENAME", "%s",
+					conf->node_name);
+		result = run_command(&run_command_args);
+		env_array_free(run_command_args.env);
+		if (rc) {
+			error("%s: init script: %s failed",
+			      __func__, jc_conf->initscript);
+			xfree(result);
+			goto exit2;
+		} else {
+			log_flag(JOB_CONT, "initscript stdout: %s", result);
+		}
+		xfree(result);
+	}
+
+	rc = mkdir(src_bind, 0700);
+	if (rc && (errno != EEXIST)) {
+		error("%s: mkdir failed %s, %m", __func__, src_bind);
+		goto exit2;
+	}
+
+	if (jc_conf->ns_template &&
+	    ((tmpl_fd = _get_template_fd()) != -1))
+		from_template = true;
+
+	job_ns_args.job_id = job_id;
+	job_ns_args.job_mount = job_mount;
+	job_ns_args.src_bind = src_bind;
+	job_ns_args.uid = step->uid;
+	rc = _fork_ns(ns_holder, tmpl_fd, _setup_job_ns, &job_ns_args);
+
+	if (tmpl_fd != -1)
+		close(tmpl_fd);
+
 exit2:
 	if (rc) {
 		int failures;
@@ -648,6 +898,10 @@ exit2:
 	}
 
 end_it:
+	END_TIMER;
+	log_flag(JOB_CONT, "job %u namespace setup %s%s in %s",
+		 job_id, rc ? "failed" : "done",
+		 from_template ? " from template" : "", TIME_STR);
 	xfree(job_mount);
 	xfree(src_bind);
 	xfree(ns_holder);
@@ -722,11 +976,53 @@ extern int container_p_join(uint32_t job_id, uid_t uid)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Remove a directory from a detached "rm -rf" process, so that job teardown
+ * does not wait for the removal of the files left by the job. Our caller is
+ * multithreaded, so the forked processes only exec and do not log. If rm can
+ * not be started, the directory is removed by the next container_p_restore().
+ */
+static void _remove_dir_background(char *path)
+{
+	char *argv[] = { "rm", "-rf", "--", path, NULL };
+	pid_t cpid;
+	int status = 0, failures;
+
+	if ((cpid = fork()) == 0) {
+		pid_t gcpid;
+
+		/* rm is reparented to init when we exit, nobody waits for it */
+		if ((gcpid = fork()) == 0) {
+			closeall(0);
+			(void) setsid();
+			execv("/bin/rm", argv);
+			_exit(127);
+		}
+		_exit((gcpid < 0) ? 1 : 0);
+	} else if (cpid > 0) {
+		if (waitpid(cpid, &status, 0) != cpid) {
+			error("%s: waitpid failed: %m", __func__);
+			return;
+		}
+		if (WIFEXITED(status) && !WEXITSTATUS(status))
+			return;
+		error("%s: fork failed, removing %s now", __func__, path);
+	} else {
+		error("%s: fork failed, removing %s now: %m", __func__, path);
+	}
+
+	if ((failures = rmdir_recursive(path, true)))
+		error("%s: failed to remove %d files from %s",
+		      __func__, failures, path);
+}
+
 static int _delete_ns(uint32_t job_id)
 {
-	char *job_mount = NULL, *ns_holder = NULL;
+	char *job_mount = NULL, *ns_holder = NULL, *trash = NULL;
 	int rc = 0, failures = 0;
+	DEF_TIMERS;
 
+	START_TIMER;
 	_create_paths(job_id, &job_mount, &ns_holder, NULL);
 
 	errno = 0;
@@ -764,16 +1060,33 @@ static int _delete_ns(uint32_t job_id)
 		}
 	}
 
-	if ((failures = rmdir_recursive(job_mount, false)))
-		error("%s: failed to remove %d files from %s",
-		      __func__, failures, job_mount);
+	/*
+	 * Move the job directory out of the way and remove its contents in
+	 * the background, the job id may be used again right away (requeue).
+	 */
 	if (umount2(job_mount, MNT_DETACH))
 		log_flag(JOB_CONT, "umount2: %s failed: %m", job_mount);
-	if (rmdir(job_mount))
-		error("rmdir %s failed: %m", job_mount);
+	xstrfmtcat(trash, "%s/%s%u.%d",
+		   jc_conf->basepath, TRASH_PREFIX, job_id, (int) getpid());
+	if (!rename(job_mount, trash)) {
+		_remove_dir_background(trash);
+	} else {
+		if (errno != ENOENT)
+			log_flag(JOB_CONT, "rename %s to %s failed: %m",
+				 job_mount, trash);
+		if ((failures = rmdir_recursive(job_mount, false)))
+			error("%s: failed to remove %d files from %s",
+			      __func__, failures, job_mount);
+		if (rmdir(job_mount))
+			error("rmdir %s failed: %m", job_mount);
+	}
 
+	END_TIMER;
+	log_flag(JOB_CONT, "job %u namespace teardown done in %s",
+		 job_id, TIME_STR);
 	xfree(job_mount);
 	xfree(ns_holder);
+	xfree(trash);
 
 	return SLURM_SUCCESS;
 }
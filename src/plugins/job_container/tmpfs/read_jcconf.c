@@ -54,6 +54,7 @@ static slurm_jc_conf_t slurm_jc_conf;
 static buf_t *slurm_jc_conf_buf = NULL;
 static bool slurm_jc_conf_inited = false;
 static bool auto_basepath_set = false;
+static bool ns_template_set = false;
 static bool shared_set = false;
 
 static s_p_hashtbl_t *_create_ns_hashtbl(void)
@@ -63,6 +64,7 @@ static s_p_hashtbl_t *_create_ns_hashtbl(void)
 		{"BasePath", S_P_STRING},
 		{"Dirs", S_P_STRING},
 		{"InitScript", S_P_STRING},
+		{"NamespaceTemplate", S_P_BOOLEAN},
 		{"Shared", S_P_BOOLEAN},
 		{NULL}
 	};
@@ -81,6 +83,7 @@ static void _pack_slurm_jc_conf_buf(void)
 	packstr(slurm_jc_conf.dirs, slurm_jc_conf_buf);
 	packstr(slurm_jc_conf.initscript, slurm_jc_conf_buf);
 	packbool(slurm_jc_conf.shared, slurm_jc_conf_buf);
+	packbool(slurm_jc_conf.ns_template, slurm_jc_conf_buf);
 }
 
 static int _parse_jc_conf_internal(void **dest, slurm_parser_enum_t type,
@@ -118,6 +121,10 @@ static int _parse_jc_conf_internal(void **dest, slurm_parser_enum_t type,
 	if (!s_p_get_string(&slurm_jc_conf.initscript, "InitScript", tbl))
 		debug3("empty init script detected");
 
+	if (s_p_get_boolean(&slurm_jc_conf.ns_template, "NamespaceTemplate",
+			    tbl))
+		ns_template_set = true;
+
 	if (s_p_get_boolean(&slurm_jc_conf.shared, "Shared", tbl))
 		shared_set = true;
 
@@ -163,6 +170,7 @@ static int _read_slurm_jc_conf(void)
 		{"AutoBasePath", S_P_BOOLEAN},
 		{"BasePath", S_P_ARRAY, _parse_jc_conf_internal, NULL},
 		{"Dirs", S_P_STRING},
+		{"NamespaceTemplate", S_P_BOOLEAN},
 		{"NodeName", S_P_ARRAY, _parse_jc_conf, NULL},
 		{"Shared", S_P_BOOLEAN},
 		{NULL}
@@ -203,6 +211,10 @@ static int _read_slurm_jc_conf(void)
 		      tmpfs_conf_file);
 	}
 
+	if (!ns_template_set)
+		s_p_get_boolean(&slurm_jc_conf.ns_template,
+				"NamespaceTemplate", tbl);
+
 	if (!shared_set)
 		s_p_get_boolean(&slurm_jc_conf.shared, "Shared", tbl);
 
@@ -255,6 +267,7 @@ extern slurm_jc_conf_t *set_slurm_jc_conf(buf_t *buf)
 	safe_unpackstr(&slurm_jc_conf.dirs, buf);
 	safe_unpackstr(&slurm_jc_conf.initscript, buf);
 	safe_unpackbool(&slurm_jc_conf.shared, buf);
+	safe_unpackbool(&slurm_jc_conf.ns_template, buf);
 	slurm_jc_conf_inited = true;
 
 	return &slurm_jc_conf;
@@ -51,6 +51,7 @@ typedef struct slurm_jc_conf {
 	char *basepath;
 	char *dirs;
 	char *initscript;
+	bool ns_template;
 	bool shared;
 } slurm_jc_conf_t;
 
@@ -38,6 +38,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "src/common/slurm_xlator.h"
+#include "src/common/hostlist.h"
+
+#include "client.h"
 #include "kvs.h"
 #include "setup.h"
 #include "tree.h"
@@ -68,6 +72,28 @@ static int temp_kvs_size = 0;
 
 static int no_dup_keys = 0;
 
+/*
+ * For allgather fence. Stepds exchange their KVS pairs by recursive
+ * doubling among the largest power of two number of nodes. The nodes
+ * beyond that fold their pairs into a partner first and get the complete
+ * set back from it at the end. Round 0 is the fold, rounds 1 to
+ * ag_rounds the doubling, and round ag_rounds + 1 the unfold.
+ */
+typedef struct {
+	char *node;
+	char *data;
+	uint32_t len;
+} ag_send_args_t;
+
+static hostlist_t *ag_nodes = NULL;
+static uint32_t ag_pow2 = 0;	/* largest power of 2 <= nnodes */
+static int ag_rounds = 0;	/* log2(ag_pow2) */
+static int ag_active = 0;	/* allgather of ag_seq in progress */
+static int ag_seq = 0;
+static int ag_round = 0;	/* current round */
+static bool ag_sent = false;	/* sent our data for current round */
+static buf_t **ag_pending[2] = { NULL, NULL }; /* [seq % 2][round] */
+
 #define TASKS_PER_BUCKET 8
 #define TEMP_KVS_SIZE_INC 2048
 
@@ -90,6 +116,18 @@ _hash(char *key)
 	return hash;
 }
 
+/* allgather fence messages carry only the KVS pairs */
+static void _temp_kvs_reset(void)
+{
+	xfree(temp_kvs_buf);
+	temp_kvs_cnt = 0;
+	temp_kvs_size = TEMP_KVS_SIZE_INC;
+	temp_kvs_buf = xmalloc(temp_kvs_size);
+
+	tasks_to_wait = 0;
+	children_to_wait = 0;
+}
+
 extern int
 temp_kvs_init(void)
 {
@@ -97,6 +135,11 @@ temp_kvs_init(void)
 	uint32_t nodeid, num_children, size;
 	buf_t *buf = NULL;
 
+	if (in_stepd() && tree_info.kvs_allgather) {
+		_temp_kvs_reset();
+		return SLURM_SUCCESS;
+	}
+
 	xfree(temp_kvs_buf);
 	temp_kvs_cnt = 0;
 	temp_kvs_size = TEMP_KVS_SIZE_INC;
@@ -184,6 +227,261 @@ extern int temp_kvs_merge(buf_t *buf)
 	return SLURM_SUCCESS;
 }
 
+static void *_ag_send_thread(void *arg)
+{
+	ag_send_args_t *args = arg;
+	int rc = SLURM_ERROR, retry = 0;
+	unsigned int delay = 1;
+
+	while (1) {
+		rc = slurm_forward_data(&args->node, tree_sock_addr,
+					args->len, args->data);
+		if (rc == SLURM_SUCCESS)
+			break;
+		if (++retry >= MAX_RETRIES)
+			break;
+		verbose("failed to send kvs allgather to %s, rc=%d, retrying",
+			args->node, rc);
+		/* wait, in case peer stepd not ready */
+		sleep(delay);
+		delay *= 2;
+	}
+
+	if (rc != SLURM_SUCCESS) {
+		error("mpi/pmi2: failed to send kvs allgather to %s",
+		      args->node);
+		/* cancel the step to avoid tasks hang */
+		slurm_kill_job_step(job_info.step_id.job_id,
+				    job_info.step_id.step_id, SIGKILL, 0);
+	}
+
+	xfree(args->node);
+	xfree(args->data);
+	xfree(args);
+	return NULL;
+}
+
+/*
+ * Send our current pairs to a peer stepd. Sends run in their own thread
+ * as both peers of a round send to each other at the same time, and the
+ * agent thread must keep reading to avoid both blocking on full sockets.
+ */
+static void _ag_send(uint32_t nodeid, int round)
+{
+	ag_send_args_t *args = xmalloc(sizeof(*args));
+	buf_t *buf;
+	char *node;
+
+	buf = init_buf(temp_kvs_cnt + 64);
+	pack16(TREE_CMD_KVS_ALLGATHER, buf);
+	pack32(ag_seq, buf);
+	pack32(round, buf);
+	pack32(job_info.nodeid, buf);
+	if (remaining_buf(buf) < temp_kvs_cnt)
+		grow_buf(buf, temp_kvs_cnt);
+	memcpy(get_buf_data(buf) + get_buf_offset(buf), temp_kvs_buf,
+	       temp_kvs_cnt);
+	set_buf_offset(buf, get_buf_offset(buf) + temp_kvs_cnt);
+
+	node = hostlist_nth(ag_nodes, nodeid);
+	args->node = xstrdup(node);
+	free(node);
+	args->len = get_buf_offset(buf);
+	args->data = xfer_buf_data(buf);
+
+	debug3("mpi/pmi2: kvs allgather seq=%d round=%d sending %u bytes to %s",
+	       ag_seq, round, args->len, args->node);
+	slurm_thread_create_detached(_ag_send_thread, args);
+}
+
+/* Merge pairs received for round, return false if not received yet */
+static bool _ag_recv(int round)
+{
+	buf_t **pending = &ag_pending[ag_seq % 2][round];
+
+	if (!*pending)
+		return false;
+
+	/* unfold data already includes our own pairs */
+	if (round == ag_rounds + 1)
+		temp_kvs_cnt = 0;
+	temp_kvs_merge(*pending);
+	FREE_NULL_BUFFER(*pending);
+
+	return true;
+}
+
+/* Put all gathered pairs into the local KVS and release the tasks */
+static void _ag_finish(void)
+{
+	int rc = SLURM_SUCCESS;
+	char *key, *val, *errmsg = NULL;
+	uint32_t temp32;
+	buf_t *buf;
+
+	ag_active = 0;
+
+	buf = create_buf(temp_kvs_buf, temp_kvs_cnt);
+	temp_kvs_buf = NULL;
+	while (remaining_buf(buf) > 0) {
+		safe_unpackstr_xmalloc(&key, &temp32, buf);
+		safe_unpackstr_xmalloc(&val, &temp32, buf);
+		kvs_put(key, val);
+		xfree(key);
+		xfree(val);
+	}
+
+resp:
+	FREE_NULL_BUFFER(buf);
+	_temp_kvs_reset();
+
+	debug3("mpi/pmi2: kvs allgather seq=%d done, rc=%d", ag_seq, rc);
+	send_kvs_fence_resp_to_clients(rc, errmsg);
+	if (rc != SLURM_SUCCESS)
+		slurm_kill_job_step(job_info.step_id.job_id,
+				    job_info.step_id.step_id, SIGKILL, 0);
+	return;
+
+unpack_error:
+	error("mpi/pmi2: unpack kvs error in allgather");
+	rc = SLURM_ERROR;
+	errmsg = "mpi/pmi2: unpack kvs error in allgather";
+	goto resp;
+}
+
+/* Advance the allgather as far as the received data allows */
+static void _ag_progress(void)
+{
+	uint32_t id = job_info.nodeid;
+	uint32_t rem = job_info.nnodes - ag_pow2;
+
+	while (ag_active) {
+		if (ag_round == 0) {
+			if (id >= ag_pow2) {
+				_ag_send(id - ag_pow2, 0);
+				ag_round = ag_rounds + 1;
+				continue;
+			}
+			if ((id < rem) && !_ag_recv(0))
+				return;
+			ag_round = 1;
+			ag_sent = false;
+		} else if (ag_round <= ag_rounds) {
+			if (!ag_sent) {
+				_ag_send(id ^ (1 << (ag_round - 1)), ag_round);
+				ag_sent = true;
+			}
+			if (!_ag_recv(ag_round))
+				return;
+			ag_round++;
+			ag_sent = false;
+		} else {
+			if (id >= ag_pow2) {
+				if (!_ag_recv(ag_round))
+					return;
+			} else if (id < rem) {
+				_ag_send(id + ag_pow2, ag_round);
+			}
+			_ag_finish();
+		}
+	}
+}
+
+/*
+ * Return the node that sends to us in round, or NO_VAL if we receive
+ * nothing in that round
+ */
+static uint32_t _ag_recv_peer(uint32_t round)
+{
+	uint32_t id = job_info.nodeid;
+	uint32_t rem = job_info.nnodes - ag_pow2;
+
+	if (round == 0)
+		return (id < rem) ? (id + ag_pow2) : NO_VAL;
+	if (round <= ag_rounds)
+		return (id < ag_pow2) ? (id ^ (1 << (round - 1))) : NO_VAL;
+	return (id >= ag_pow2) ? (id - ag_pow2) : NO_VAL;
+}
+
+static void _ag_init(void)
+{
+	if (ag_nodes)
+		return;
+
+	ag_nodes = hostlist_create(job_info.step_nodelist);
+	for (ag_pow2 = 1; (ag_pow2 * 2) <= job_info.nnodes; ag_pow2 *= 2)
+		ag_rounds++;
+	for (int i = 0; i < 2; i++)
+		ag_pending[i] = xcalloc(ag_rounds + 2, sizeof(buf_t *));
+}
+
+static int _ag_start(void)
+{
+	_ag_init();
+
+	ag_seq = kvs_seq;
+	kvs_seq++; /* expecting new kvs after now */
+	ag_active = 1;
+	ag_round = 0;
+	ag_sent = false;
+
+	debug3("mpi/pmi2: kvs allgather seq=%d start", ag_seq);
+	_ag_progress();
+
+	return SLURM_SUCCESS;
+}
+
+extern int kvs_allgather_recv(buf_t *buf)
+{
+	uint32_t seq, round, from_nodeid, size;
+	buf_t **pending;
+	char *data;
+
+	safe_unpack32(&seq, buf);
+	safe_unpack32(&round, buf);
+	safe_unpack32(&from_nodeid, buf);
+
+	/* a peer may start the first fence before we did */
+	_ag_init();
+
+	if (round > ag_rounds + 1) {
+		error("mpi/pmi2: invalid kvs allgather round %u from node %u",
+		      round, from_nodeid);
+		return SLURM_ERROR;
+	}
+	if (from_nodeid != _ag_recv_peer(round)) {
+		error("mpi/pmi2: unexpected kvs allgather from node %u "
+		      "in round %u", from_nodeid, round);
+		return SLURM_ERROR;
+	}
+	if (!(ag_active && (seq == ag_seq)) && (seq != kvs_seq)) {
+		error("mpi/pmi2: invalid kvs allgather seq from node %u, "
+		      "expect %d got %u", from_nodeid, kvs_seq, seq);
+		return SLURM_ERROR;
+	}
+
+	pending = &ag_pending[seq % 2][round];
+	if (*pending) {
+		info("mpi/pmi2: duplicate kvs allgather from node %u ignored, "
+		     "seq=%u round=%u", from_nodeid, seq, round);
+		return SLURM_SUCCESS;
+	}
+
+	size = remaining_buf(buf);
+	data = xmalloc(size + 1);
+	memcpy(data, get_buf_data(buf) + get_buf_offset(buf), size);
+	*pending = create_buf(data, size);
+
+	if (ag_active && (seq == ag_seq))
+		_ag_progress();
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("mpi/pmi2: failed to unpack kvs allgather message");
+	return SLURM_ERROR;
+}
+
 extern int
 temp_kvs_send(void)
 {
@@ -191,6 +489,9 @@ temp_kvs_send(void)
 	unsigned int delay = 1;
 	char *nodelist = NULL;
 
+	if (in_stepd() && tree_info.kvs_allgather)
+		return _ag_start();
+
 	if (!in_stepd())	/* srun */
 		nodelist = xstrdup(job_info.step_nodelist);
 	else if (tree_info.parent_node)
@@ -54,6 +54,8 @@ extern int   temp_kvs_add(char *key, char *val);
 extern int   temp_kvs_merge(buf_t *buf);
 extern int   temp_kvs_send(void);
 
+extern int   kvs_allgather_recv(buf_t *buf);
+
 extern int   kvs_init(void);
 extern char *kvs_get(char *key);
 extern int   kvs_put(char *key, char *val);
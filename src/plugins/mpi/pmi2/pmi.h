@@ -234,6 +234,7 @@
 #define PMI2_PPVAL_ENV          "SLURM_PMI2_PPVAL"
 #define SLURM_STEP_RESV_PORTS   "SLURM_STEP_RESV_PORTS"
 #define PMIX_RING_TREE_WIDTH_ENV "SLURM_PMIX_RING_WIDTH"
+#define PMI2_KVS_FENCE_ENV      "SLURM_PMI2_KVS_FENCE"
 /* old PMIv1 envs */
 #define PMI2_PMI_DEBUGGED_ENV   "PMI_DEBUG"
 #define PMI2_KVS_NO_DUP_KEYS_ENV "SLURM_PMI_KVS_NO_DUP_KEYS"
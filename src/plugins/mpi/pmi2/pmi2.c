@@ -292,7 +292,9 @@ _handle_kvs_fence(int fd, int lrank, client_req_t *req)
 	       job_info.gtids[lrank]);
 	if (tasks_to_wait == 0 && children_to_wait == 0) {
 		tasks_to_wait = job_info.ltasks;
-		children_to_wait = tree_info.num_children;
+		/* allgather fences do not pass through the tree */
+		children_to_wait = tree_info.kvs_allgather ?
+				   0 : tree_info.num_children;
 	}
 	tasks_to_wait --;
 
@@ -309,7 +311,11 @@ _handle_kvs_fence(int fd, int lrank, client_req_t *req)
 			slurm_kill_job_step(job_info.step_id.job_id,
 					    job_info.step_id.step_id,
 					    SIGKILL, 0);
-		} else {
+		} else if (!tree_info.kvs_allgather) {
+			/*
+			 * An allgather fence gets no response from the tree
+			 * and may already have released the tasks here.
+			 */
 			waiting_kvs_resp = 1;
 		}
 	}
@@ -233,6 +233,13 @@ _setup_stepd_tree_info(char ***env)
 		tree_width = slurm_conf.tree_width;
 	}
 
+	p = getenvp(*env, PMI2_KVS_FENCE_ENV);
+	if (p && !xstrcasecmp(p, "allgather"))
+		tree_info.kvs_allgather = true;
+	else if (p && xstrcasecmp(p, "tree"))
+		info("invalid PMI2 KVS fence value (%s) detected. "
+		     "fallback to tree.", p);
+
 	/* TODO: cannot launch 0 tasks on node */
 
 	/*
@@ -89,6 +89,7 @@ typedef struct pmi2_tree_info {
 	uint16_t pmi_port;	 /* PMI2 comm port of this srun */
 	slurm_addr_t *srun_addr; /* PMI2 comm address parent srun */
 	uint32_t *children_kvs_seq; /* sequence number of children nodes */
+	bool kvs_allgather;	/* fence by allgather among stepds */
 } pmi2_tree_info_t;
 
 
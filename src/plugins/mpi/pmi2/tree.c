@@ -69,6 +69,7 @@ static int _handle_name_unpublish(int fd, buf_t *buf);
 static int _handle_name_lookup(int fd, buf_t *buf);
 static int _handle_ring(int fd, buf_t *buf);
 static int _handle_ring_resp(int fd, buf_t *buf);
+static int _handle_kvs_allgather(int fd, buf_t *buf);
 
 static uint32_t  spawned_srun_ports_size = 0;
 static uint16_t *spawned_srun_ports = NULL;
@@ -84,6 +85,7 @@ static int (*tree_cmd_handlers[]) (int fd, buf_t *buf) = {
 	_handle_name_lookup,
 	_handle_ring,
 	_handle_ring_resp,
+	_handle_kvs_allgather,
 	NULL
 };
 
@@ -97,6 +99,7 @@ static char *tree_cmd_names[] = {
 	"TREE_CMD_NAME_LOOKUP",
 	"TREE_CMD_RING",
 	"TREE_CMD_RING_RESP",
+	"TREE_CMD_KVS_ALLGATHER",
 	NULL,
 };
 
@@ -585,6 +588,17 @@ unpack_error:
 	goto out;
 }
 
+/* handles KVS pairs from a peer stepd in an allgather fence */
+static int _handle_kvs_allgather(int fd, buf_t *buf)
+{
+	if (!in_stepd() || !tree_info.kvs_allgather) {
+		error("mpi/pmi2: unexpected kvs allgather message");
+		return SLURM_ERROR;
+	}
+
+	return kvs_allgather_recv(buf);
+}
+
 /**************************************************************/
 extern int
 handle_tree_cmd(int fd)
@@ -296,6 +296,58 @@ void pmixp_coll_log(pmixp_coll_t *coll)
 	}
 }
 
+/*
+ * Make room for size more bytes of collective data. Grow geometrically so
+ * that gathering from many nodes does not reallocate and copy the whole
+ * buffer for every contribution.
+ */
+int pmixp_coll_buf_reserve(buf_t *buf, size_t size)
+{
+	uint64_t grow = MAX(size, size_buf(buf));
+
+	if (remaining_buf(buf) >= size)
+		return SLURM_SUCCESS;
+
+	if ((size_buf(buf) + grow) > MAX_BUF_SIZE)
+		grow = size - remaining_buf(buf);
+
+	return try_grow_buf(buf, grow);
+}
+
+void pmixp_coll_tv_mark(struct timeval *tv)
+{
+	if (get_log_level() >= LOG_LEVEL_DEBUG)
+		gettimeofday(tv, NULL);
+}
+
+static long _tv_diff(struct timeval *from, struct timeval *to)
+{
+	if (!from->tv_sec || !to->tv_sec)
+		return -1;
+	return (to->tv_sec - from->tv_sec) * USEC_IN_SEC +
+		(to->tv_usec - from->tv_usec);
+}
+
+/* Report the fence phases on local delivery and clear the timestamps */
+void pmixp_coll_tv_log(pmixp_coll_t *coll, uint32_t seq, size_t size,
+		       pmixp_coll_tv_t *tv)
+{
+	struct timeval now = { 0 };
+
+	pmixp_coll_tv_mark(&now);
+	if (now.tv_sec) {
+		if (!tv->bcast.tv_sec)
+			tv->bcast = now;
+		PMIXP_DEBUG("%p: %s seq=%u size=%zu timings(usec): collect=%ld bcast=%ld deliver=%ld total=%ld",
+			    coll, pmixp_coll_type2str(coll->type), seq, size,
+			    _tv_diff(&tv->local, &tv->collect),
+			    _tv_diff(&tv->collect, &tv->bcast),
+			    _tv_diff(&tv->bcast, &now),
+			    _tv_diff(&tv->local, &now));
+	}
+	memset(tv, 0, sizeof(*tv));
+}
+
 void pmixp_coll_localcb_nodata(pmixp_coll_t *coll, int status)
 {
 	if (coll->cbfunc) {
@@ -38,6 +38,8 @@
 
 #ifndef PMIXP_COLL_H
 #define PMIXP_COLL_H
+#include <sys/time.h>
+
 #include "pmixp_common.h"
 #include "pmixp_debug.h"
 
@@ -155,6 +157,13 @@ typedef enum {
 	PMIXP_COLL_REQ_FAILURE
 } pmixp_coll_req_state_t;
 
+/* fence phase timestamps, only taken when debug logging is enabled */
+typedef struct {
+	struct timeval local;	/* local contribution received */
+	struct timeval collect;	/* all contributions gathered */
+	struct timeval bcast;	/* fence result available */
+} pmixp_coll_tv_t;
+
 /* tree coll struct */
 typedef struct {
 	/* general information */
@@ -182,6 +191,8 @@ typedef struct {
 	/* collective data */
 	buf_t *ufwd_buf, *dfwd_buf;
 	size_t serv_offs, dfwd_offset, ufwd_offset;
+
+	pmixp_coll_tv_t tv;
 } pmixp_coll_tree_t;
 
 /* PMIx Ring collective */
@@ -206,6 +217,7 @@ typedef struct {
 	bool *contrib_map;
 	pmixp_ring_state_t state;
 	buf_t *ring_buf;
+	pmixp_coll_tv_t tv;
 } pmixp_coll_ring_ctx_t;
 
 /* coll ring struct */
@@ -344,6 +356,10 @@ int pmixp_coll_contrib_local(pmixp_coll_t *coll, pmixp_coll_type_t type,
 			     void *cbfunc, void *cbdata);
 void pmixp_coll_free(pmixp_coll_t *coll);
 void pmixp_coll_localcb_nodata(pmixp_coll_t *coll, int status);
+int pmixp_coll_buf_reserve(buf_t *buf, size_t size);
+void pmixp_coll_tv_mark(struct timeval *tv);
+void pmixp_coll_tv_log(pmixp_coll_t *coll, uint32_t seq, size_t size,
+		       pmixp_coll_tv_t *tv);
 int pmixp_coll_belong_chk(const pmix_proc_t *procs, size_t nprocs);
 void pmixp_coll_log(pmixp_coll_t *coll);
 void pmixp_coll_ring_log(pmixp_coll_t *coll);
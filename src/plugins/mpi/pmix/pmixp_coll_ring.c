@@ -311,6 +311,7 @@ static void _reset_coll_ring(pmixp_coll_ring_ctx_t *coll_ctx)
 	coll_ctx->forward_cnt = 0;
 	coll->ts = time(NULL);
 	memset(coll_ctx->contrib_map, 0, sizeof(bool) * coll->peers_cnt);
+	memset(&coll_ctx->tv, 0, sizeof(coll_ctx->tv));
 	coll_ctx->ring_buf = NULL;
 }
 
@@ -349,6 +350,7 @@ static void _invoke_callback(pmixp_coll_ring_ctx_t *coll_ctx)
 	data = get_buf_data(coll_ctx->ring_buf);
 	data_sz = get_buf_offset(coll_ctx->ring_buf);
 	cbdata = xmalloc(sizeof(pmixp_coll_ring_cbdata_t));
+	pmixp_coll_tv_log(coll, coll_ctx->seq, data_sz, &coll_ctx->tv);
 
 	cbdata->coll = coll;
 	cbdata->coll_ctx = coll_ctx;
@@ -384,6 +386,7 @@ static void _progress_coll_ring(pmixp_coll_ring_ctx_t *coll_ctx)
 			/* check for all data is collected and forwarded */
 			if (!_ring_remain_contrib(coll_ctx) ) {
 				coll_ctx->state = PMIXP_COLL_RING_FINALIZE;
+				pmixp_coll_tv_mark(&coll_ctx->tv.collect);
 				_invoke_callback(coll_ctx);
 				ret = true;
 			}
@@ -536,7 +539,7 @@ inline static int _pmixp_coll_contrib(pmixp_coll_ring_ctx_t *coll_ctx,
 	coll->ts = time(NULL);
 
 	/* save contribution */
-	if (try_grow_buf_remaining(coll_ctx->ring_buf, size))
+	if (pmixp_coll_buf_reserve(coll_ctx->ring_buf, size))
 		return SLURM_ERROR;
 
 	data_ptr = get_buf_data(coll_ctx->ring_buf) +
@@ -588,6 +591,16 @@ int pmixp_coll_ring_local(pmixp_coll_t *coll, char *data, size_t size,
 		    coll_ctx, coll_ctx->seq, coll_ctx->state, size);
 #endif
 
+	pmixp_coll_tv_mark(&coll_ctx->tv.local);
+
+	/*
+	 * Contributions from the other nodes are usually about the size of
+	 * ours, reserve room for all of them at once.
+	 */
+	if (size && (((uint64_t) size * coll->peers_cnt) < MAX_BUF_SIZE))
+		(void) pmixp_coll_buf_reserve(coll_ctx->ring_buf,
+					      size * coll->peers_cnt);
+
 	if (_pmixp_coll_contrib(coll_ctx, coll->my_peerid, 0, data, size)) {
 		goto exit;
 	}
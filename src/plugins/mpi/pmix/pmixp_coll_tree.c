@@ -495,6 +495,7 @@ static int _progress_collect(pmixp_coll_t *coll)
 		/* Not yet ready to go to the next step */
 		return 0;
 	}
+	pmixp_coll_tv_mark(&tree->tv.collect);
 
 	if (pmixp_info_srv_direct_conn()) {
 		/* We will need to forward aggregated
@@ -531,7 +532,7 @@ static int _progress_collect(pmixp_coll_t *coll)
 			tree->ufwd_offset;
 		size_t size = get_buf_offset(tree->ufwd_buf) -
 			tree->ufwd_offset;
-		if (try_grow_buf_remaining(tree->dfwd_buf, size))
+		if (pmixp_coll_buf_reserve(tree->dfwd_buf, size))
 			return 0;
 		dst = get_buf_data(tree->dfwd_buf) + tree->dfwd_offset;
 		memcpy(dst, src, size);
@@ -540,6 +541,7 @@ static int _progress_collect(pmixp_coll_t *coll)
 		tree->ufwd_status = PMIXP_COLL_TREE_SND_DONE;
 		/* this is root */
 		tree->contrib_prnt = true;
+		pmixp_coll_tv_mark(&tree->tv.bcast);
 	}
 
 	if (PMIXP_EP_NONE != ep.type) {
@@ -693,6 +695,7 @@ static int _progress_ufwd(pmixp_coll_t *coll)
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
 		tree->dfwd_cb_wait++;
+		pmixp_coll_tv_log(coll, coll->seq, size, &tree->tv);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS,
 				       data, size, coll->cbdata,
 				       _libpmix_cb, (void*)cbdata);
@@ -783,6 +786,7 @@ static int _progress_ufwd_wpc(pmixp_coll_t *coll)
 		char *data = get_buf_data(tree->dfwd_buf) + tree->dfwd_offset;
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
+		pmixp_coll_tv_log(coll, coll->seq, size, &tree->tv);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS, data, size,
 				       coll->cbdata, _libpmix_cb,
 				       (void *)cbdata);
@@ -960,7 +964,8 @@ int pmixp_coll_tree_local(pmixp_coll_t *coll, char *data, size_t size,
 
 	/* save & mark local contribution */
 	tree->contrib_local = true;
-	if ((ret = try_grow_buf_remaining(tree->ufwd_buf, size)))
+	pmixp_coll_tv_mark(&tree->tv.local);
+	if ((ret = pmixp_coll_buf_reserve(tree->ufwd_buf, size)))
 		goto exit;
 	memcpy(get_buf_data(tree->ufwd_buf) + get_buf_offset(tree->ufwd_buf),
 	       data, size);
@@ -1117,7 +1122,7 @@ int pmixp_coll_tree_child(pmixp_coll_t *coll, uint32_t peerid, uint32_t seq,
 
 	data_src = get_buf_data(buf) + get_buf_offset(buf);
 	size = remaining_buf(buf);
-	if (try_grow_buf_remaining(tree->ufwd_buf, size))
+	if (pmixp_coll_buf_reserve(tree->ufwd_buf, size))
 		goto error;
 	data_dst = get_buf_data(tree->ufwd_buf) +
 		get_buf_offset(tree->ufwd_buf);
@@ -1269,10 +1274,11 @@ int pmixp_coll_tree_parent(pmixp_coll_t *coll, uint32_t peerid, uint32_t seq,
 		goto proceed;
 	}
 	tree->contrib_prnt = true;
+	pmixp_coll_tv_mark(&tree->tv.bcast);
 
 	data_src = get_buf_data(buf) + get_buf_offset(buf);
 	size = remaining_buf(buf);
-	if (try_grow_buf_remaining(tree->dfwd_buf, size))
+	if (pmixp_coll_buf_reserve(tree->dfwd_buf, size))
 		goto error;
 	data_dst = get_buf_data(tree->dfwd_buf) +
 		get_buf_offset(tree->dfwd_buf);
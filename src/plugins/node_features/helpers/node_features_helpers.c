@@ -208,7 +208,7 @@ static int _feature_set_state(const plugin_feature_t *feature)
 	return rc;
 }
 
-static List _feature_get_state(const plugin_feature_t *feature)
+static List _helper_get_state(const char *helper)
 {
 	char *tmp, *saveptr;
 	char *output = NULL;
@@ -216,7 +216,7 @@ static List _feature_get_state(const plugin_feature_t *feature)
 	List result = list_create(xfree_ptr);
 	run_command_args_t run_command_args = {
 		.max_wait = (exec_time * 1000),
-		.script_path = feature->helper,
+		.script_path = helper,
 		.script_type = "get_state",
 		.status = &rc };
 
@@ -770,30 +770,86 @@ static int _foreach_check_duplicates(void *x, void *y)
 	return 0;
 }
 
+/* One distinct helper program, queried once for all of its features */
 typedef struct {
-	char **avail_modes;
-	List all_current;
-} _foreach_modes_t;
+	const char *helper;
+	List current;
+	pthread_t tid;
+} helper_query_t;
 
-static int _foreach_helper_get_modes(void *x, void *y)
+static void _helper_query_destroy(void *x)
 {
-	char **avail_modes = ((_foreach_modes_t *)y)->avail_modes;
-	List all_current = ((_foreach_modes_t *)y)->all_current;
-	plugin_feature_t *feature = (plugin_feature_t *)x;
+	helper_query_t *query = x;
 
-	List current = _feature_get_state(feature);
+	FREE_NULL_LIST(query->current);
+	xfree(query);
+}
+
+static int _cmp_helper_query(void *x, void *key)
+{
+	helper_query_t *query = x;
 
-	xstrfmtcat(*avail_modes, "%s%s", (*avail_modes ? "," : ""), feature->name);
+	return !xstrcmp(query->helper, key);
+}
+
+static int _foreach_add_helper_query(void *x, void *y)
+{
+	plugin_feature_t *feature = x;
+	List queries = y;
+	helper_query_t *query;
 
-	if (!current || list_is_empty(current)) {
-		FREE_NULL_LIST(current);
+	if (!feature->helper ||
+	    list_find_first(queries, _cmp_helper_query,
+			    (void *) feature->helper))
 		return 0;
-	}
+
+	query = xmalloc(sizeof(*query));
+	query->helper = feature->helper;
+	list_append(queries, query);
+
+	return 0;
+}
+
+static void *_helper_query_thread(void *arg)
+{
+	helper_query_t *query = arg;
+
+	query->current = _helper_get_state(query->helper);
+
+	return NULL;
+}
+
+static int _foreach_helper_query_start(void *x, void *y)
+{
+	helper_query_t *query = x;
+
+	slurm_thread_create(&query->tid, _helper_query_thread, query);
+
+	return 0;
+}
+
+static int _foreach_helper_query_merge(void *x, void *y)
+{
+	helper_query_t *query = x;
+	List all_current = y;
+
+	slurm_thread_join(query->tid);
 
 	/* filter out duplicates */
-	list_for_each(current, _foreach_check_duplicates, all_current);
+	if (query->current)
+		list_for_each(query->current, _foreach_check_duplicates,
+			      all_current);
+
+	return 0;
+}
+
+static int _foreach_avail_mode(void *x, void *y)
+{
+	plugin_feature_t *feature = x;
+	char **avail_modes = y;
 
-	FREE_NULL_LIST(current);
+	xstrfmtcat(*avail_modes, "%s%s", (*avail_modes ? "," : ""),
+		   feature->name);
 
 	return 0;
 }
@@ -802,7 +858,7 @@ extern void node_features_p_node_state(char **avail_modes, char **current_mode)
 {
 	List all_current = NULL;
 	List filtered_modes = NULL;
-	_foreach_modes_t args;
+	List queries = NULL;
 
 	if (!avail_modes || !current_mode)
 		return;
@@ -812,13 +868,18 @@ extern void node_features_p_node_state(char **avail_modes, char **current_mode)
 
 	all_current = list_create(xfree_ptr);
 
-	args.all_current = all_current;
-	args.avail_modes = avail_modes;
+	list_for_each(helper_features, _foreach_avail_mode, avail_modes);
 
 	/*
-	 * Call every helper with no args to get list of active features
+	 * Call every helper with no args to get list of active features.
+	 * Features usually share a helper, so each distinct helper is run
+	 * only once, and all of them run at the same time.
 	 */
-	list_for_each(helper_features, _foreach_helper_get_modes, &args);
+	queries = list_create(_helper_query_destroy);
+	list_for_each(helper_features, _foreach_add_helper_query, queries);
+	list_for_each(queries, _foreach_helper_query_start, NULL);
+	list_for_each(queries, _foreach_helper_query_merge, all_current);
+	FREE_NULL_LIST(queries);
 
 	filtered_modes = list_create(xfree_ptr);
 
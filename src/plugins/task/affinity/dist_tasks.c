@@ -61,9 +61,13 @@ static int _get_local_node_info(slurm_cred_arg_t *arg, int job_node_id,
 				uint16_t *sockets, uint16_t *cores);
 
 static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
-				   uint32_t node_id, bitstr_t ***masks_p);
+				   uint32_t node_id, bitstr_t *avail_map,
+				   uint16_t hw_sockets, uint16_t hw_cores,
+				   uint16_t hw_threads, bitstr_t ***masks_p);
 static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
-				    uint32_t node_id, bitstr_t ***masks_p);
+				    uint32_t node_id, bitstr_t *avail_map,
+				    uint16_t hw_sockets, uint16_t hw_cores,
+				    uint16_t hw_threads, bitstr_t ***masks_p);
 
 static void _lllp_map_abstract_masks(const uint32_t maxtasks,
 				     bitstr_t **masks);
@@ -71,6 +75,37 @@ static void _lllp_generate_cpu_bind(launch_tasks_request_msg_t *req,
 				    const uint32_t maxtasks,
 				    bitstr_t **masks);
 
+/*
+ * Masks generated for recent launch requests. Steps of a job usually repeat
+ * the same layout, so the generated cpu_bind string is reused when every input
+ * of the layout matches.
+ */
+#define MASK_CACHE_SIZE 16
+
+typedef struct {
+	uint32_t job_id;
+	bitstr_t *avail_map;		/* CPUs allocated on this node */
+	uint16_t cpu_bind_type;
+	uint32_t task_dist;
+	uint16_t max_tasks;
+	uint16_t cpus_per_task;
+	uint16_t threads_per_core;
+	uint16_t ntasks_per_core;
+	uint16_t ntasks_per_socket;
+	bool overcommit;
+	uint16_t select_type_param;
+	uint16_t hw_sockets;		/* hardware layout behind avail_map */
+	uint16_t hw_cores;
+	uint16_t hw_threads;
+
+	char *cpu_bind;			/* results of the layout */
+	uint16_t cpu_bind_type_out;
+	uint16_t cpus_per_task_out;
+} mask_cache_t;
+
+static List mask_cache = NULL;
+static pthread_mutex_t mask_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /*     BLOCK_MAP     physical machine LLLP index to abstract block LLLP index
  *     BLOCK_MAP_INV physical abstract block LLLP index to machine LLLP index
  */
@@ -339,6 +374,118 @@ static int _validate_mask(launch_tasks_request_msg_t *req, char *avail_mask,
 	return rc;
 }
 
+static void _mask_cache_free(void *x)
+{
+	mask_cache_t *entry = x;
+
+	if (!entry)
+		return;
+	FREE_NULL_BITMAP(entry->avail_map);
+	xfree(entry->cpu_bind);
+	xfree(entry);
+}
+
+static int _find_mask_cache(void *x, void *key)
+{
+	mask_cache_t *entry = x, *want = key;
+
+	if ((entry->job_id != want->job_id) ||
+	    (entry->cpu_bind_type != want->cpu_bind_type) ||
+	    (entry->task_dist != want->task_dist) ||
+	    (entry->max_tasks != want->max_tasks) ||
+	    (entry->cpus_per_task != want->cpus_per_task) ||
+	    (entry->threads_per_core != want->threads_per_core) ||
+	    (entry->ntasks_per_core != want->ntasks_per_core) ||
+	    (entry->ntasks_per_socket != want->ntasks_per_socket) ||
+	    (entry->overcommit != want->overcommit) ||
+	    (entry->select_type_param != want->select_type_param))
+		return 0;
+
+	return bit_equal(entry->avail_map, want->avail_map);
+}
+
+/*
+ * Fill in the layout inputs of a launch request. key->avail_map is also what
+ * the layout functions work from, so it is only built once per launch.
+ * RET false if the allocated CPUs could not be determined
+ */
+static bool _mask_cache_key(launch_tasks_request_msg_t *req, uint32_t node_id,
+			    mask_cache_t *key)
+{
+	memset(key, 0, sizeof(*key));
+	if (!(key->avail_map = _get_avail_map(req->cred, &key->hw_sockets,
+					       &key->hw_cores,
+					       &key->hw_threads)))
+		return false;
+
+	key->job_id = req->step_id.job_id;
+	key->cpu_bind_type = req->cpu_bind_type;
+	key->task_dist = req->task_dist;
+	key->max_tasks = req->tasks_to_launch[node_id];
+	key->cpus_per_task = req->cpus_per_task;
+	key->threads_per_core = req->threads_per_core;
+	key->ntasks_per_core = req->ntasks_per_core;
+	key->ntasks_per_socket = req->ntasks_per_socket;
+	key->overcommit = (req->flags & LAUNCH_OVERCOMMIT);
+	key->select_type_param = slurm_conf.select_type_param;
+
+	return true;
+}
+
+/* RET true if req was filled in from a previous identical layout */
+static bool _mask_cache_get(launch_tasks_request_msg_t *req,
+			    mask_cache_t *key)
+{
+	mask_cache_t *entry;
+	char buf_type[100];
+
+	slurm_mutex_lock(&mask_cache_mutex);
+	if (!mask_cache ||
+	    !(entry = list_find_first(mask_cache, _find_mask_cache, key))) {
+		slurm_mutex_unlock(&mask_cache_mutex);
+		return false;
+	}
+
+	xfree(req->cpu_bind);
+	req->cpu_bind = xstrdup(entry->cpu_bind);
+	req->cpu_bind_type = entry->cpu_bind_type_out;
+	req->cpus_per_task = entry->cpus_per_task_out;
+	slurm_mutex_unlock(&mask_cache_mutex);
+
+	slurm_sprint_cpu_bind_type(buf_type, req->cpu_bind_type);
+	info("JobId=%u reusing the cpu_bind of an identical layout: %s, %s",
+	     req->step_id.job_id, buf_type, req->cpu_bind);
+
+	return true;
+}
+
+/* Record the result of a layout, consuming key */
+static void _mask_cache_add(launch_tasks_request_msg_t *req, mask_cache_t *key)
+{
+	mask_cache_t *entry = xmalloc(sizeof(*entry));
+
+	*entry = *key;
+	key->avail_map = NULL;
+	entry->cpu_bind = xstrdup(req->cpu_bind);
+	entry->cpu_bind_type_out = req->cpu_bind_type;
+	entry->cpus_per_task_out = req->cpus_per_task;
+
+	slurm_mutex_lock(&mask_cache_mutex);
+	if (!mask_cache)
+		mask_cache = list_create(_mask_cache_free);
+	list_enqueue(mask_cache, entry);
+	while (list_count(mask_cache) > MASK_CACHE_SIZE)
+		_mask_cache_free(list_dequeue(mask_cache));
+	slurm_mutex_unlock(&mask_cache_mutex);
+}
+
+extern void lllp_distribution_fini(void)
+{
+	slurm_mutex_lock(&mask_cache_mutex);
+	FREE_NULL_LIST(mask_cache);
+	slurm_mutex_unlock(&mask_cache_mutex);
+}
+
 /*
  * lllp_distribution
  *
@@ -375,6 +522,7 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 		CPU_BIND_LDMASK | CPU_BIND_LDRANK |
 		CPU_BIND_LDMAP;
 	static int only_one_thread_per_core = -1;
+	mask_cache_t key = { 0 };
 
 	if (only_one_thread_per_core == -1) {
 		if (conf->cpus == (conf->sockets * conf->cores))
@@ -517,6 +665,15 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 		     req->step_id.job_id, buf_type, req->task_dist);
 	}
 
+	if (!_mask_cache_key(req, node_id, &key)) {
+		rc = ESLURMD_CPU_LAYOUT_ERROR;
+		goto layout_done;
+	}
+	if (_mask_cache_get(req, &key)) {
+		FREE_NULL_BITMAP(key.avail_map);
+		return rc;
+	}
+
 	switch (req->task_dist & SLURM_DIST_NODESOCKMASK) {
 	case SLURM_DIST_BLOCK_BLOCK:
 	case SLURM_DIST_CYCLIC_BLOCK:
@@ -524,7 +681,9 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 		debug2("JobId=%u will use lllp_block",
 		       req->step_id.job_id);
 		/* tasks are distributed in blocks within a plane */
-		rc = _task_layout_lllp_block(req, node_id, &masks);
+		rc = _task_layout_lllp_block(req, node_id, key.avail_map,
+					     key.hw_sockets, key.hw_cores,
+					     key.hw_threads, &masks);
 		break;
 	case SLURM_DIST_ARBITRARY:
 	case SLURM_DIST_BLOCK:
@@ -533,7 +692,11 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 		if (slurm_conf.select_type_param & CR_CORE_DEFAULT_DIST_BLOCK) {
 			debug2("JobId=%u will use lllp_block because of SelectTypeParameters",
 			       req->step_id.job_id);
-			rc = _task_layout_lllp_block(req, node_id, &masks);
+			rc = _task_layout_lllp_block(req, node_id,
+						     key.avail_map,
+						     key.hw_sockets,
+						     key.hw_cores,
+						     key.hw_threads, &masks);
 			break;
 		}
 		/*
@@ -543,10 +706,13 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 	default:
 		debug2("JobId=%u will use lllp_cyclic because of SelectTypeParameters",
 		       req->step_id.job_id);
-		rc = _task_layout_lllp_cyclic(req, node_id, &masks);
+		rc = _task_layout_lllp_cyclic(req, node_id, key.avail_map,
+					      key.hw_sockets, key.hw_cores,
+					      key.hw_threads, &masks);
 		break;
 	}
 
+layout_done:
 	/*
 	 * FIXME: I'm worried about core_bitmap with CPU_BIND_TO_SOCKETS &
 	 * max_cores - does select/cons_tres plugin allocate whole
@@ -566,6 +732,7 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 #endif
 		/* convert masks into cpu_bind mask string */
 		_lllp_generate_cpu_bind(req, maxtasks, masks);
+		_mask_cache_add(req, &key);
 	} else {
 		char *avail_mask = _alloc_mask(req,
 					       &whole_nodes,  &whole_sockets,
@@ -595,6 +762,7 @@ extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 	}
 	if (masks)
 		_lllp_free_masks(maxtasks, masks);
+	FREE_NULL_BITMAP(key.avail_map);
 	return rc;
 }
 
@@ -856,58 +1024,51 @@ static bitstr_t *_get_avail_map(slurm_cred_t *cred, uint16_t *hw_sockets,
 	return hw_map;
 }
 
-/* helper function for _expand_masks() */
-static void _blot_mask(bitstr_t *mask, bitstr_t *avail_map, uint16_t blot)
+/*
+ * helper function for _expand_masks()
+ * Build one bitmap per block of "blot" bits containing the bits of avail_map
+ * within that block, so that masks can be expanded a word at a time.
+ */
+static bitstr_t **_build_blot_maps(bitstr_t *avail_map, int blot,
+				   int *blot_cnt)
 {
-	uint16_t i, j, size = 0;
-	int prev = -1;
+	int size = bit_size(avail_map);
+	int cnt = (size + blot - 1) / blot;
+	bitstr_t **blot_maps = xcalloc(cnt, sizeof(bitstr_t *));
 
-	if (!mask)
-		return;
-	size = bit_size(mask);
-	for (i = 0; i < size; i++) {
-		if (bit_test(mask, i)) {
-			/* fill in this blot */
-			uint16_t start = (i / blot) * blot;
-			if (start != prev) {
-				for (j = start; j < start + blot; j++) {
-					if (bit_test(avail_map, j))
-						bit_set(mask, j);
-				}
-				prev = start;
-			}
-		}
+	for (int i = 0; i < cnt; i++) {
+		int start = i * blot;
+
+		blot_maps[i] = bit_alloc(size);
+		bit_nset(blot_maps[i], start, MIN(start + blot, size) - 1);
+		bit_and(blot_maps[i], avail_map);
 	}
+
+	*blot_cnt = cnt;
+	return blot_maps;
 }
 
-/* helper function for _expand_masks()
- * for each task, consider which other bits are set in avail_map
- * on the same socket */
-static void _blot_mask_sockets(const uint32_t maxtasks, const uint32_t task,
-			       bitstr_t **masks, uint16_t hw_sockets,
-			       uint16_t hw_cores, uint16_t hw_threads,
-			       bitstr_t *avail_map)
+/*
+ * helper function for _expand_masks()
+ * for each block with a bit set in mask, set all of the block's bits that are
+ * also set in avail_map
+ */
+static void _blot_mask(bitstr_t *mask, bitstr_t **blot_maps, int blot_cnt,
+		       int blot)
 {
-  	uint16_t i, j, size = 0;
-	int blot;
-
-	if (!masks[task])
- 		return;
-
-	blot = bit_size(avail_map) / hw_sockets;
-	if (blot <= 0)
-		blot = 1;
-	size = bit_size(masks[task]);
-	for (i = 0; i < size; i++) {
-		if (bit_test(masks[task], i)) {
-			/* check if other bits are set in avail_map on this
-			 * socket and set each corresponding bit in masks */
-			uint16_t start = (i / blot) * blot;
-			for (j = start; j < start+blot; j++) {
-				if (bit_test(avail_map, j))
-					bit_set(masks[task], j);
-			}
-		}
+	bitoff_t i = 0;
+	int block;
+
+	if (!mask)
+		return;
+	xassert(bit_size(mask) == bit_size(blot_maps[0]));
+
+	while ((i = bit_ffs_from_bit(mask, i)) >= 0) {
+		block = i / blot;
+		if (block >= blot_cnt)
+			break;
+		bit_or(mask, blot_maps[block]);
+		i = (block + 1) * blot;
 	}
 }
 
@@ -918,6 +1079,8 @@ static void _expand_masks(uint16_t cpu_bind_type, const uint32_t maxtasks,
 			  uint16_t hw_cores, uint16_t hw_threads,
 			  bitstr_t *avail_map)
 {
+	bitstr_t **blot_maps;
+	int blot, blot_cnt = 0;
 	uint32_t i;
 
 	if (cpu_bind_type & CPU_BIND_TO_THREADS)
@@ -925,20 +1088,24 @@ static void _expand_masks(uint16_t cpu_bind_type, const uint32_t maxtasks,
 	if (cpu_bind_type & CPU_BIND_TO_CORES) {
 		if (hw_threads < 2)
 			return;
-		for (i = 0; i < maxtasks; i++) {
-			_blot_mask(masks[i], avail_map, hw_threads);
-		}
-		return;
-	}
-	if (cpu_bind_type & CPU_BIND_TO_SOCKETS) {
+		blot = hw_threads;
+	} else if (cpu_bind_type & CPU_BIND_TO_SOCKETS) {
 		if (hw_threads*hw_cores < 2)
 			return;
-		for (i = 0; i < maxtasks; i++) {
-			_blot_mask_sockets(maxtasks, i, masks, hw_sockets,
-					   hw_cores, hw_threads, avail_map);
-		}
+		/* consider all bits set in avail_map on the same socket */
+		blot = bit_size(avail_map) / hw_sockets;
+		if (blot <= 0)
+			blot = 1;
+	} else {
 		return;
 	}
+
+	blot_maps = _build_blot_maps(avail_map, blot, &blot_cnt);
+	for (i = 0; i < maxtasks; i++)
+		_blot_mask(masks[i], blot_maps, blot_cnt, blot);
+	for (i = 0; i < blot_cnt; i++)
+		FREE_NULL_BITMAP(blot_maps[i]);
+	xfree(blot_maps);
 }
 
 /*
@@ -968,14 +1135,15 @@ static void _expand_masks(uint16_t cpu_bind_type, const uint32_t maxtasks,
  *
  */
 static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
-				    uint32_t node_id, bitstr_t ***masks_p)
+				    uint32_t node_id, bitstr_t *avail_map,
+				    uint16_t hw_sockets, uint16_t hw_cores,
+				    uint16_t hw_threads, bitstr_t ***masks_p)
 {
 	int last_taskcount = -1, taskcount = 0;
-	uint16_t i, s, hw_sockets = 0, hw_cores = 0, hw_threads = 0;
+	uint16_t i, s;
 	uint16_t offset = 0, p = 0;
 	int size, max_tasks = req->tasks_to_launch[node_id];
 	int max_cpus = max_tasks * req->cpus_per_task;
-	bitstr_t *avail_map;
 	bitstr_t **masks = NULL;
 	int *socket_last_pu = NULL;
 	int core_inx, pu_per_core, *core_tasks = NULL, *core_threads = NULL;
@@ -983,11 +1151,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 
 	info ("_task_layout_lllp_cyclic ");
 
-	avail_map = _get_avail_map(req->cred, &hw_sockets, &hw_cores,
-				   &hw_threads);
-	if (!avail_map)
-		return ESLURMD_CPU_LAYOUT_ERROR;
-
 	if (req->threads_per_core && (req->threads_per_core != NO_VAL16))
 		req_threads_per_core = req->threads_per_core;
 	else if (req->cpu_bind_type & CPU_BIND_ONE_THREAD_PER_CORE)
@@ -1005,7 +1168,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 			      size,
 			      (req->cpus_per_task * (conf->threads /
 						     req_threads_per_core)));
-			FREE_NULL_BITMAP(avail_map);
 			return ESLURMD_CPU_LAYOUT_ERROR;
 		}
 	}
@@ -1013,7 +1175,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 		if (!(req->flags & LAUNCH_OVERCOMMIT))
 			error("only %d bits in avail_map for %d tasks!",
 			      size, max_tasks);
-		FREE_NULL_BITMAP(avail_map);
 		return ESLURMD_CPU_LAYOUT_ERROR;
 	}
 	if (size < max_cpus) {
@@ -1039,7 +1200,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 	while (taskcount < max_tasks) {
 		if (taskcount == last_taskcount) {
 			error("_task_layout_lllp_cyclic failure");
-			FREE_NULL_BITMAP(avail_map);
 			xfree(core_tasks);
 			xfree(core_threads);
 			xfree(socket_last_pu);
@@ -1151,7 +1311,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 	 * to the requested resource */
 	_expand_masks(req->cpu_bind_type, max_tasks, masks,
 		      hw_sockets, hw_cores, hw_threads, avail_map);
-	FREE_NULL_BITMAP(avail_map);
 	xfree(core_tasks);
 	xfree(core_threads);
 	xfree(socket_last_pu);
@@ -1182,13 +1341,13 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
  *
  */
 static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
-				   uint32_t node_id, bitstr_t ***masks_p)
+				   uint32_t node_id, bitstr_t *avail_map,
+				   uint16_t hw_sockets, uint16_t hw_cores,
+				   uint16_t hw_threads, bitstr_t ***masks_p)
 {
 	int c, i, size, last_taskcount = -1, taskcount = 0;
-	uint16_t hw_sockets = 0, hw_cores = 0, hw_threads = 0;
 	int max_tasks = req->tasks_to_launch[node_id];
 	int max_cpus = max_tasks * req->cpus_per_task;
-	bitstr_t *avail_map;
 	bitstr_t **masks = NULL;
 	int core_inx, pu_per_core, *core_tasks = NULL, *core_threads = NULL;
 	int sock_inx, pu_per_socket, *socket_tasks = NULL;
@@ -1196,12 +1355,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 
 	info("_task_layout_lllp_block ");
 
-	avail_map = _get_avail_map(req->cred, &hw_sockets, &hw_cores,
-				   &hw_threads);
-	if (!avail_map) {
-		return ESLURMD_CPU_LAYOUT_ERROR;
-	}
-
 	if (req->threads_per_core && (req->threads_per_core != NO_VAL16))
 		req_threads_per_core = req->threads_per_core;
 	else if (req->cpu_bind_type & CPU_BIND_ONE_THREAD_PER_CORE)
@@ -1219,7 +1372,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 			      size,
 			      (req->cpus_per_task * (conf->threads /
 						     req_threads_per_core)));
-			FREE_NULL_BITMAP(avail_map);
 			return ESLURMD_CPU_LAYOUT_ERROR;
 		}
 	}
@@ -1227,7 +1379,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 		if (!(req->flags & LAUNCH_OVERCOMMIT))
 			error("only %d bits in avail_map for %d tasks!",
 			      size, max_tasks);
-		FREE_NULL_BITMAP(avail_map);
 		return ESLURMD_CPU_LAYOUT_ERROR;
 	}
 	if (size < max_cpus) {
@@ -1253,7 +1404,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 	while (taskcount < max_tasks) {
 		if (taskcount == last_taskcount) {
 			error("_task_layout_lllp_block infinite loop");
-			FREE_NULL_BITMAP(avail_map);
 			xfree(core_tasks);
 			xfree(core_threads);
 			xfree(socket_tasks);
@@ -1329,7 +1479,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 	 * to the requested resource */
 	_expand_masks(req->cpu_bind_type, max_tasks, masks,
 		      hw_sockets, hw_cores, hw_threads, avail_map);
-	FREE_NULL_BITMAP(avail_map);
 
 	return SLURM_SUCCESS;
 }
@@ -1350,16 +1499,13 @@ static bitstr_t *_lllp_map_abstract_mask(bitstr_t *bitmask)
 	newmask = (bitstr_t *) bit_alloc(num_bits);
 
 	/* remap to physical machine */
-	for (i = 0; i < num_bits; i++) {
-		if (bit_test(bitmask,i)) {
-			bit = BLOCK_MAP(i);
-			if (bit < bit_size(newmask))
-				bit_set(newmask, bit);
-			else
-				error("can't go from %d -> %d since we "
-				      "only have %"BITSTR_FMT" bits",
-				      i, bit, bit_size(newmask));
-		}
+	for (i = 0; (i = bit_ffs_from_bit(bitmask, i)) >= 0; i++) {
+		bit = BLOCK_MAP(i);
+		if (bit < num_bits)
+			bit_set(newmask, bit);
+		else
+			error("can't go from %d -> %d since we "
+			      "only have %d bits", i, bit, num_bits);
 	}
 	return newmask;
 }
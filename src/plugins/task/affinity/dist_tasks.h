@@ -43,4 +43,7 @@ void batch_bind(batch_job_launch_msg_t *req);
 extern int lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id,
 			     char **err_msg);
 
+/* Free masks cached by lllp_distribution() */
+extern void lllp_distribution_fini(void);
+
 #endif /* !_SLURMSTEPD_DIST_TASKS_H */
@@ -104,6 +104,7 @@ extern int init (void)
  */
 extern int fini (void)
 {
+	lllp_distribution_fini();
 	debug("%s unloaded", plugin_name);
 	return SLURM_SUCCESS;
 }
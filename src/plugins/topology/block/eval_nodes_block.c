@@ -53,6 +53,74 @@ static int _cmp_bblock(const void *a, const void *b)
 	return 0;
 }
 
+typedef struct {
+	int inx;			/* index in block_record_table */
+	uint32_t node_cnt;		/* usable nodes on this base block */
+} bblock_fit_t;
+
+static int _cmp_bblock_fit(const void *a, const void *b)
+{
+	const bblock_fit_t *fa = a, *fb = b;
+
+	if (fa->node_cnt != fb->node_cnt)
+		return (fa->node_cnt < fb->node_cnt) ? -1 : 1;
+	return (fa->inx < fb->inx) ? -1 : (fa->inx > fb->inx);
+}
+
+/*
+ * Pick and remove the best base block from fit, which is sorted by node count.
+ * Choose the smallest base block that satisfies rem_nodes, otherwise the
+ * largest one. Ties go to the highest index, as in _choose_best_bblock().
+ * RET index in block_record_table or -1 if no candidates remain
+ */
+static int _pick_best_fit_bblock(bblock_fit_t *fit, int *fit_cnt,
+				 int rem_nodes)
+{
+	int lo = 0, hi = *fit_cnt, pick, inx;
+
+	if (!*fit_cnt)
+		return -1;
+
+	/*
+	 * First base block with enough nodes. A negative rem_nodes means that
+	 * only CPUs or GRES are still missing. _choose_best_bblock() compares
+	 * it as unsigned then and takes the largest base block, so do the same.
+	 */
+	if (rem_nodes < 0)
+		lo = *fit_cnt;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if ((int) fit[mid].node_cnt < rem_nodes)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < *fit_cnt) {
+		uint32_t node_cnt = fit[lo].node_cnt;
+
+		/* Last base block with that same node count */
+		hi = *fit_cnt;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (fit[mid].node_cnt <= node_cnt)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		pick = lo - 1;
+	} else {
+		pick = *fit_cnt - 1;
+	}
+
+	inx = fit[pick].inx;
+	(*fit_cnt)--;
+	memmove(&fit[pick], &fit[pick + 1],
+		(*fit_cnt - pick) * sizeof(bblock_fit_t));
+
+	return inx;
+}
+
 static bool _bblocks_in_same_block(int block_inx1, int block_inx2,
 				   int block_level)
 {
@@ -126,6 +194,9 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 	bitstr_t **bblock_node_bitmap = NULL;	/* nodes on this base block */
 	uint32_t *block_node_cnt = NULL;	/* total nodes on block */
 	uint32_t *nodes_on_bblock = NULL;	/* total nodes on bblock */
+	bblock_fit_t *bblock_fit = NULL;	/* bblocks sorted by node count */
+	int bblock_fit_cnt = 0;
+	uint32_t bblock_free_nodes = 0;		/* nodes on unused bblocks */
 	bitstr_t *avail_nodes_bitmap = NULL;	/* nodes on any block */
 	bitstr_t *req_nodes_bitmap = NULL;	/* required node bitmap */
 	bitstr_t *req2_nodes_bitmap = NULL;	/* required+lowest prio nodes */
@@ -659,12 +730,32 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 		bit_and(bblock_node_bitmap[i], block_node_bitmap[block_inx]);
 		bit_and(bblock_node_bitmap[i], best_nodes_bitmap);
 		nodes_on_bblock[i] = bit_set_count(bblock_node_bitmap[i]);
+		bblock_free_nodes += nodes_on_bblock[i];
 		if (nodes_on_llblock) {
 			int llblock_inx = i / bblock_per_llblock;
 			nodes_on_llblock[llblock_inx] += nodes_on_bblock[i];
 		}
 	}
 
+	/*
+	 * Without llblock constraints the choice of base block only depends on
+	 * its node count, which does not change as base blocks are consumed, so
+	 * search a sorted array instead of rescanning every base block.
+	 */
+	if (!nodes_on_llblock) {
+		bblock_fit = xcalloc(block_record_cnt, sizeof(*bblock_fit));
+		for (i = 0; i < block_record_cnt; i++) {
+			if (!bblock_node_bitmap[i])
+				continue;
+			bblock_fit[bblock_fit_cnt].inx = i;
+			bblock_fit[bblock_fit_cnt].node_cnt =
+				nodes_on_bblock[i];
+			bblock_fit_cnt++;
+		}
+		qsort(bblock_fit, bblock_fit_cnt, sizeof(*bblock_fit),
+		      _cmp_bblock_fit);
+	}
+
 	prev_rem_nodes = rem_nodes + 1;
 	while (1) {
 		int best_bblock_inx = -1;
@@ -672,8 +763,10 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 		bitstr_t *best_bblock_bitmap = NULL;
 		if (prev_rem_nodes == rem_nodes)
 			break; 	/* Stalled */
+		if (!bblock_free_nodes)
+			break;	/* Every usable base block is consumed */
 		prev_rem_nodes = rem_nodes;
-		for (i = 0; i < block_record_cnt; i++) {
+		for (i = 0; (i < block_record_cnt) && nodes_on_llblock; i++) {
 			if (block_inx != bblock_block_inx[i])
 				continue;
 			if (bit_test(bblock_required, i))
@@ -684,6 +777,9 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 					    &best_same_block, &best_fit,
 					    &best_bblock_inx);
 		}
+		if (!nodes_on_llblock)
+			best_bblock_inx = _pick_best_fit_bblock(
+				bblock_fit, &bblock_fit_cnt, rem_nodes);
 		log_flag(SELECT_TYPE, "%s: rem_nodes:%d  best_bblock_inx:%d",
 			 __func__, rem_nodes, best_bblock_inx);
 		if (best_bblock_inx == -1)
@@ -698,6 +794,16 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 		best_bblock_bitmap = bblock_node_bitmap[best_bblock_inx];
 		bit_and_not(best_bblock_bitmap, topo_eval->node_map);
 		bit_set(bblock_required, best_bblock_inx);
+
+		/*
+		 * Keep the free node counts current as base blocks are
+		 * consumed rather than recounting the bitmaps.
+		 */
+		bblock_free_nodes -= nodes_on_bblock[best_bblock_inx];
+		if (nodes_on_llblock)
+			nodes_on_llblock[best_bblock_inx >> llblock_level] -=
+				nodes_on_bblock[best_bblock_inx];
+		nodes_on_bblock[best_bblock_inx] = 0;
 		/*
 		 * NOTE: Ideally we would add nodes in order of resource
 		 * availability rather than in order of bitmap position, but
@@ -766,6 +872,7 @@ fini:
 	}
 	xfree(block_node_cnt);
 	xfree(nodes_on_bblock);
+	xfree(bblock_fit);
 	xfree(nodes_on_llblock);
 	FREE_NULL_BITMAP(bblock_required);
 	return rc;
@@ -124,6 +124,68 @@ static void _topo_choose_best_switch(uint32_t *dist, int *switch_node_cnt,
 	}
 }
 
+/*
+ * Intersect every switch with node_map and count its nodes and available CPUs.
+ * Leaf switches are intersected directly. Higher level switches are built
+ * bottom-up from their children's results, so each available node's CPUs are
+ * only summed once per leaf rather than once per level of the tree.
+ */
+static void _topo_switch_avail(bitstr_t *node_map,
+			       avail_res_t **avail_res_array,
+			       bitstr_t **switch_node_bitmap,
+			       int *switch_node_cnt, uint32_t *switch_cpu_cnt)
+{
+	switch_record_t *switch_ptr;
+	node_record_t *node_ptr;
+	int i, j, level;
+
+	for (level = 0; level <= switch_levels; level++) {
+		for (i = 0, switch_ptr = switch_record_table;
+		     i < switch_record_cnt; i++, switch_ptr++) {
+			uint32_t switch_cpus = 0;
+
+			if (switch_ptr->level != level)
+				continue;
+
+			if (!switch_ptr->num_switches) {
+				switch_node_bitmap[i] =
+					bit_copy(switch_ptr->node_bitmap);
+				bit_and(switch_node_bitmap[i], node_map);
+			} else {
+				switch_node_bitmap[i] = bit_alloc(
+					bit_size(node_map));
+				for (j = 0; j < switch_ptr->num_switches; j++) {
+					uint16_t child =
+						switch_ptr->switch_index[j];
+					bit_or(switch_node_bitmap[i],
+					       switch_node_bitmap[child]);
+				}
+			}
+			switch_node_cnt[i] = bit_set_count(
+				switch_node_bitmap[i]);
+
+			if (switch_ptr->num_switches &&
+			    switch_ptr->disjoint_children) {
+				for (j = 0; j < switch_ptr->num_switches; j++)
+					switch_cpus += switch_cpu_cnt[
+						switch_ptr->switch_index[j]];
+			} else {
+				/*
+				 * Count total CPUs of the intersection of
+				 * node_map and switch_node_bitmap.
+				 */
+				for (j = 0;
+				     (node_ptr = next_node_bitmap(
+					     switch_node_bitmap[i], &j));
+				     j++)
+					switch_cpus +=
+						avail_res_array[j]->avail_cpus;
+			}
+			switch_cpu_cnt[i] = switch_cpus;
+		}
+	}
+}
+
 /*
  * Allocate resources to the job on one leaf switch if possible,
  * otherwise distribute the job allocation over many leaf switches.
@@ -894,21 +956,10 @@ static int _eval_nodes_topo(topology_eval_t *topo_eval)
 	switch_required    = xcalloc(switch_record_cnt, sizeof(int));
 	req_switch_required = xcalloc(switch_record_cnt, sizeof(int));
 
-	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
-	     i++, switch_ptr++) {
-		uint32_t switch_cpus = 0;
-		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
-		bit_and(switch_node_bitmap[i], topo_eval->node_map);
-		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
-		/*
-		 * Count total CPUs of the intersection of node_map and
-		 * switch_node_bitmap.
-		 */
-		for (j = 0; (node_ptr = next_node_bitmap(switch_node_bitmap[i],
-							 &j));
-		     j++)
-			switch_cpus += avail_res_array[j]->avail_cpus;
-		switch_cpu_cnt[i] = switch_cpus;
+	_topo_switch_avail(topo_eval->node_map, avail_res_array,
+			   switch_node_bitmap, switch_node_cnt, switch_cpu_cnt);
+
+	for (i = 0; i < switch_record_cnt; i++) {
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, switch_node_bitmap[i])) {
 			switch_required[i] = 1;
@@ -339,6 +339,32 @@ static void _find_child_switches(int sw)
 	hostlist_destroy(swlist);
 }
 
+/*
+ * Flag switches whose direct descendants have no nodes in common, so that
+ * per-switch node and CPU counts can be summed from the children rather than
+ * recounted from the switch's own node_bitmap.
+ */
+static void _set_disjoint_children(int sw)
+{
+	switch_record_t *switch_ptr = &switch_record_table[sw];
+	int child_node_cnt = 0;
+
+	if (!switch_ptr->node_bitmap)
+		return;
+
+	for (int i = 0; i < switch_ptr->num_switches; i++) {
+		uint16_t child = switch_ptr->switch_index[i];
+
+		if (!switch_record_table[child].node_bitmap)
+			return;
+		child_node_cnt +=
+			bit_set_count(switch_record_table[child].node_bitmap);
+	}
+
+	switch_ptr->disjoint_children =
+		(child_node_cnt == bit_set_count(switch_ptr->node_bitmap));
+}
+
 static void _check_better_path(int i, int j ,int k)
 {
 	int tmp;
@@ -517,6 +543,7 @@ extern void switch_record_validate(void)
 	for (i = 0; i < switch_record_cnt; i++) {
 		if (switch_record_table[i].level != 0) {
 			_find_child_switches(i);
+			_set_disjoint_children(i);
 		}
 		if (node_count ==
 			bit_set_count(switch_record_table[i].node_bitmap)) {
@@ -43,6 +43,8 @@
  *  defined here but is really tree plugin related
 \*****************************************************************************/
 typedef struct {
+	bool disjoint_children;		/* direct descendant switches share
+					 * no nodes */
 	int level;			/* level in hierarchy, leaf=0 */
 	uint32_t link_speed;		/* link speed, arbitrary units */
 	char *name;			/* switch name */
@@ -105,6 +105,114 @@ typedef struct topoinfo_tree {
 	topoinfo_switch_t *topo_array;	/* the switch topology records */
 } topoinfo_tree_t;
 
+/*
+ * Cache of recent topology_p_split_hostlist() results. Messages to the same
+ * set of nodes (e.g. job launch, signal and kill) are split identically, so
+ * the switch walk is only done once per node set until the next reconfig.
+ */
+#define SPLIT_CACHE_SIZE 64
+
+typedef struct {
+	int count;			/* number of entries in sp_hl */
+	int first;			/* bit_ffs() of nodes_bitmap */
+	int last;			/* bit_fls() of nodes_bitmap */
+	uint64_t last_used;		/* split_cache_tick when last used */
+	bitstr_t *nodes_bitmap;		/* nodes the message was sent to */
+	int node_cnt;			/* bit_set_count() of nodes_bitmap */
+	hostlist_t **sp_hl;		/* subhostlists to forward to */
+} split_cache_t;
+
+static split_cache_t split_cache[SPLIT_CACHE_SIZE];
+static pthread_mutex_t split_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t split_cache_tick = 0;
+
+static void _split_cache_clear(void)
+{
+	slurm_mutex_lock(&split_cache_lock);
+	for (int i = 0; i < SPLIT_CACHE_SIZE; i++) {
+		split_cache_t *ent = &split_cache[i];
+
+		for (int j = 0; j < ent->count; j++)
+			FREE_NULL_HOSTLIST(ent->sp_hl[j]);
+		xfree(ent->sp_hl);
+		FREE_NULL_BITMAP(ent->nodes_bitmap);
+		ent->count = 0;
+	}
+	slurm_mutex_unlock(&split_cache_lock);
+}
+
+static hostlist_t **_copy_sp_hl(hostlist_t **sp_hl, int count)
+{
+	hostlist_t **copy = xcalloc(count, sizeof(hostlist_t *));
+
+	for (int i = 0; i < count; i++)
+		copy[i] = hostlist_copy(sp_hl[i]);
+
+	return copy;
+}
+
+/*
+ * Look up nodes_bitmap in the split cache.
+ * RET true and fill sp_hl/count with copies of the cached result on a hit.
+ */
+static bool _split_cache_get(bitstr_t *nodes_bitmap, hostlist_t ***sp_hl,
+			     int *count)
+{
+	int node_cnt = bit_set_count(nodes_bitmap);
+	int first = bit_ffs(nodes_bitmap), last = bit_fls(nodes_bitmap);
+	bool found = false;
+
+	slurm_mutex_lock(&split_cache_lock);
+	for (int i = 0; i < SPLIT_CACHE_SIZE; i++) {
+		split_cache_t *ent = &split_cache[i];
+
+		if (!ent->nodes_bitmap || (ent->node_cnt != node_cnt) ||
+		    (ent->first != first) || (ent->last != last) ||
+		    (bit_size(ent->nodes_bitmap) != bit_size(nodes_bitmap)) ||
+		    !bit_equal(ent->nodes_bitmap, nodes_bitmap))
+			continue;
+		ent->last_used = ++split_cache_tick;
+		*sp_hl = _copy_sp_hl(ent->sp_hl, ent->count);
+		*count = ent->count;
+		found = true;
+		break;
+	}
+	slurm_mutex_unlock(&split_cache_lock);
+
+	return found;
+}
+
+/* Save a split result, evicting the least recently used entry if full */
+static void _split_cache_put(bitstr_t *nodes_bitmap, hostlist_t **sp_hl,
+			     int count)
+{
+	split_cache_t *ent = NULL;
+
+	slurm_mutex_lock(&split_cache_lock);
+	for (int i = 0; i < SPLIT_CACHE_SIZE; i++) {
+		if (!split_cache[i].nodes_bitmap) {
+			ent = &split_cache[i];
+			break;
+		}
+		if (!ent || (split_cache[i].last_used < ent->last_used))
+			ent = &split_cache[i];
+	}
+
+	for (int j = 0; j < ent->count; j++)
+		FREE_NULL_HOSTLIST(ent->sp_hl[j]);
+	xfree(ent->sp_hl);
+	FREE_NULL_BITMAP(ent->nodes_bitmap);
+
+	ent->nodes_bitmap = bit_copy(nodes_bitmap);
+	ent->node_cnt = bit_set_count(nodes_bitmap);
+	ent->first = bit_ffs(nodes_bitmap);
+	ent->last = bit_fls(nodes_bitmap);
+	ent->sp_hl = _copy_sp_hl(sp_hl, count);
+	ent->count = count;
+	ent->last_used = ++split_cache_tick;
+	slurm_mutex_unlock(&split_cache_lock);
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  *	are called.  Put global initialization here.
@@ -121,6 +229,7 @@ extern int init(void)
  */
 extern int fini(void)
 {
+	_split_cache_clear();
 	switch_record_table_destroy();
 	return SLURM_SUCCESS;
 }
@@ -131,6 +240,7 @@ extern int fini(void)
  */
 extern int topology_p_build_config(void)
 {
+	_split_cache_clear();
 	if (node_record_count)
 		switch_record_validate();
 	return SLURM_SUCCESS;
@@ -316,6 +426,7 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 	int s_first, s_last;
 	char *buf;
 	bitstr_t *nodes_bitmap = NULL;		/* nodes in message list */
+	bitstr_t *orig_nodes_bitmap = NULL;	/* nodes_bitmap before split */
 	bitstr_t *switch_bitmap = NULL;		/* switches  */
 	slurmctld_lock_t node_read_lock = { .node = READ_LOCK };
 	static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -350,6 +461,13 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 		fatal("ROUTE: Failed to make bitmap from hostlist=%s.", buf);
 	}
 
+	if (_split_cache_get(nodes_bitmap, sp_hl, count)) {
+		if (running_in_slurmctld())
+			unlock_slurmctld(node_read_lock);
+		FREE_NULL_BITMAP(nodes_bitmap);
+		return SLURM_SUCCESS;
+	}
+
 	/* Find lowest level switches containing all the nodes in the list */
 	switch_bitmap = bit_alloc(switch_record_cnt);
 	for (j = 0; j < switch_record_cnt; j++) {
@@ -415,6 +533,7 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 	*sp_hl = xcalloc(switch_record_cnt, sizeof(hostlist_t *));
 	msg_count = hostlist_count(hl);
 	*count = 0;
+	orig_nodes_bitmap = bit_copy(nodes_bitmap);
 	for (j = s_first; j <= s_last; j++) {
 		xassert(msg_count);
 
@@ -445,9 +564,12 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 		}
 	}
 
+	_split_cache_put(orig_nodes_bitmap, *sp_hl, *count);
+
 	if (running_in_slurmctld())
 		unlock_slurmctld(node_read_lock);
 	FREE_NULL_BITMAP(nodes_bitmap);
+	FREE_NULL_BITMAP(orig_nodes_bitmap);
 	FREE_NULL_BITMAP(switch_bitmap);
 
 	return SLURM_SUCCESS;
@@ -43,6 +43,7 @@
 #include "src/common/proc_args.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_time.h"
+#include "src/common/uid.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/data_parser.h"
 #include "src/interfaces/serializer.h"
@@ -1446,6 +1447,39 @@ static void _print_env(slurmdb_job_rec_t *job)
 	return;
 }
 
+static void _list_job(slurmdb_job_rec_t *job)
+{
+	list_itr_t *itr_step = NULL;
+	slurmdb_step_rec_t *step = NULL;
+	slurmdb_job_cond_t *job_cond = params.job_cond;
+
+	if ((params.cluster_name) &&
+	    _test_local_job(job->jobid) &&
+	    xstrcmp(params.cluster_name, job->cluster))
+		return;
+
+	if (job_cond->flags & JOBCOND_FLAG_SCRIPT) {
+		_print_script(job);
+		return;
+	} else if (job_cond->flags & JOBCOND_FLAG_ENV) {
+		_print_env(job);
+		return;
+	}
+
+	if (job->show_full)
+		print_fields(JOB, job);
+
+	if (!(job_cond->flags & JOBCOND_FLAG_NO_STEP)) {
+		itr_step = list_iterator_create(job->steps);
+		while ((step = list_next(itr_step))) {
+			if (step->end == 0)
+				step->end = job->end;
+			print_fields(JOBSTEP, step);
+		}
+		list_iterator_destroy(itr_step);
+	}
+}
+
 /* do_list() -- List the assembled data
  *
  * In:	Nothing explicit.
@@ -1456,11 +1490,7 @@ static void _print_env(slurmdb_job_rec_t *job)
  */
 extern void do_list(int argc, char **argv)
 {
-	list_itr_t *itr = NULL;
-	list_itr_t *itr_step = NULL;
 	slurmdb_job_rec_t *job = NULL;
-	slurmdb_step_rec_t *step = NULL;
-	slurmdb_job_cond_t *job_cond = params.job_cond;
 
 	if (params.mimetype) {
 		DATA_DUMP_CLI_SINGLE(OPENAPI_SLURMDBD_JOBS_RESP, jobs, argc,
@@ -1472,35 +1502,14 @@ extern void do_list(int argc, char **argv)
 	if (!jobs)
 		return;
 
-	itr = list_iterator_create(jobs);
-	while ((job = list_next(itr))) {
-		if ((params.cluster_name) &&
-		    _test_local_job(job->jobid) &&
-		    xstrcmp(params.cluster_name, job->cluster))
-			continue;
-
-		if (job_cond->flags & JOBCOND_FLAG_SCRIPT) {
-			_print_script(job);
-			continue;
-		} else if (job_cond->flags & JOBCOND_FLAG_ENV) {
-			_print_env(job);
-			continue;
-		}
-
-		if (job->show_full)
-			print_fields(JOB, job);
-
-		if (!(job_cond->flags & JOBCOND_FLAG_NO_STEP)) {
-			itr_step = list_iterator_create(job->steps);
-			while ((step = list_next(itr_step))) {
-				if (step->end == 0)
-					step->end = job->end;
-				print_fields(JOBSTEP, step);
-			}
-			list_iterator_destroy(itr_step);
-		}
+	/*
+	 * Release each job once its rows are written so memory is returned
+	 * while printing rather than all at exit.
+	 */
+	while ((job = list_pop(jobs))) {
+		_list_job(job);
+		slurmdb_destroy_job_rec(job);
 	}
-	list_iterator_destroy(itr);
 }
 
 /* do_list_completion() -- List the assembled data
@@ -1551,4 +1560,6 @@ extern void sacct_fini(void)
 	}
 	xfree(params.opt_field_list);
 	slurmdb_destroy_job_cond(params.job_cond);
+	uid_cache_clear();
+	gid_cache_clear();
 }
@@ -51,10 +51,11 @@ char outbuf[FORMAT_STRING_SIZE];
 #define SACCT_TRES_MIN  0x0004
 #define SACCT_TRES_TOT  0x0008
 
-static char *_elapsed_time(uint64_t secs, uint64_t usecs)
+/* Format elapsed time into buf, return buf or NULL if secs is NO_VAL64 */
+static char *_elapsed_time(uint64_t secs, uint64_t usecs, char *buf,
+			   size_t buf_size)
 {
 	uint64_t days, hours, minutes, seconds, subsec = 0;
-	char *str = NULL;
 
 	if (secs == NO_VAL64)
 		return NULL;
@@ -73,18 +74,21 @@ static char *_elapsed_time(uint64_t secs, uint64_t usecs)
 	days    =  secs / 86400;
 
 	if (days)
-		str = xstrdup_printf("%"PRIu64"-%2.2"PRIu64":%2.2"PRIu64":%2.2"PRIu64"",
-				     days, hours, minutes, seconds);
+		snprintf(buf, buf_size,
+			 "%"PRIu64"-%2.2"PRIu64":%2.2"PRIu64":%2.2"PRIu64"",
+			 days, hours, minutes, seconds);
 	else if (hours)
-		str = xstrdup_printf("%2.2"PRIu64":%2.2"PRIu64":%2.2"PRIu64"",
-				     hours, minutes, seconds);
+		snprintf(buf, buf_size,
+			 "%2.2"PRIu64":%2.2"PRIu64":%2.2"PRIu64"",
+			 hours, minutes, seconds);
 	else if (subsec)
-		str = xstrdup_printf("%2.2"PRIu64":%2.2"PRIu64".%3.3"PRIu64"",
-				     minutes, seconds, subsec);
+		snprintf(buf, buf_size,
+			 "%2.2"PRIu64":%2.2"PRIu64".%3.3"PRIu64"",
+			 minutes, seconds, subsec);
 	else
-		str = xstrdup_printf("00:%2.2"PRIu64":%2.2"PRIu64"",
-				     minutes, seconds);
-	return str;
+		snprintf(buf, buf_size, "00:%2.2"PRIu64":%2.2"PRIu64"",
+			 minutes, seconds);
+	return buf;
 }
 
 static char *_find_qos_name_from_list(List qos_list, int qosid)
@@ -469,13 +473,13 @@ extern void print_fields(type_t type, void *object)
 				type, object, TRES_CPU, SACCT_TRES_AVE);
 			if (tmp_uint64 != NO_VAL64) {
 				tmp_uint64 /= CPU_TIME_ADJ;
-				tmp_char = _elapsed_time(tmp_uint64, 0);
+				tmp_char = _elapsed_time(tmp_uint64, 0,
+							 tmp1, sizeof(tmp1));
 			}
 
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_AVEDISKREAD:
 			tmp_uint64 = _get_tres_cnt(
@@ -917,11 +921,10 @@ extern void print_fields(type_t type, void *object)
 			default:
 				break;
 			}
-			tmp_char = gid_to_string(tmp_uint32);
+			tmp_char = gid_to_string_cached(tmp_uint32);
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_JOBID:
 			if (type == JOBSTEP)
@@ -933,14 +936,12 @@ extern void print_fields(type_t type, void *object)
 			switch (type) {
 			case JOB:
 				tmp_char = id;
-				id = NULL;
 				break;
 			case JOBSTEP:
-				tmp_int = FORMAT_STRING_SIZE;
-				tmp_char = xmalloc(tmp_int);
+				tmp_int = sizeof(tmp1);
+				tmp_char = tmp1;
 				tmp_int2 =
 					snprintf(tmp_char, tmp_int, "%s.", id);
-				xfree(id);
 				tmp_int -= tmp_int2;
 				log_build_step_id_str(&step->step_id,
 						      tmp_char + tmp_int2,
@@ -949,8 +950,9 @@ extern void print_fields(type_t type, void *object)
 						      STEP_ID_FLAG_NO_JOB);
 				break;
 			case JOBCOMP:
-				tmp_char = xstrdup_printf("%u",
-							  job_comp->jobid);
+				snprintf(tmp1, sizeof(tmp1), "%u",
+					 job_comp->jobid);
+				tmp_char = tmp1;
 				break;
 			default:
 				break;
@@ -958,16 +960,17 @@ extern void print_fields(type_t type, void *object)
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
+			xfree(id);
 			break;
 		case PRINT_JOBIDRAW:
 			switch (type) {
 			case JOB:
-				tmp_char = xstrdup_printf("%u", job->jobid);
+				snprintf(tmp1, sizeof(tmp1), "%u", job->jobid);
+				tmp_char = tmp1;
 				break;
 			case JOBSTEP:
-				tmp_int = FORMAT_STRING_SIZE;
-				tmp_char = xmalloc(tmp_int);
+				tmp_int = sizeof(tmp1);
+				tmp_char = tmp1;
 				tmp_int2 = snprintf(tmp_char, tmp_int, "%u.",
 						    step->job_ptr->jobid);
 				tmp_int -= tmp_int2;
@@ -978,8 +981,9 @@ extern void print_fields(type_t type, void *object)
 						      STEP_ID_FLAG_NO_JOB);
 				break;
 			case JOBCOMP:
-				tmp_char = xstrdup_printf("%u",
-							  job_comp->jobid);
+				snprintf(tmp1, sizeof(tmp1), "%u",
+					 job_comp->jobid);
+				tmp_char = tmp1;
 				break;
 			default:
 				break;
@@ -987,7 +991,6 @@ extern void print_fields(type_t type, void *object)
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_JOBNAME:
 			switch(type) {
@@ -1405,13 +1408,13 @@ extern void print_fields(type_t type, void *object)
 
 			if (tmp_uint64 != NO_VAL64) {
 				tmp_uint64 /= CPU_TIME_ADJ;
-				tmp_char = _elapsed_time(tmp_uint64, 0);
+				tmp_char = _elapsed_time(tmp_uint64, 0,
+							 tmp1, sizeof(tmp1));
 			}
 
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_MINCPUNODE:
 			tmp_char = _get_tres_node(type, object, TRES_CPU,
@@ -1904,12 +1907,12 @@ extern void print_fields(type_t type, void *object)
 			default:
 				break;
 			}
-			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64);
+			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64,
+						 tmp1, sizeof(tmp1));
 
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_SYSTEM_COMMENT:
 			switch(type) {
@@ -1984,12 +1987,12 @@ extern void print_fields(type_t type, void *object)
 			default:
 				break;
 			}
-			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64);
+			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64,
+						 tmp1, sizeof(tmp1));
 
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_TRESA:
 			switch(type) {
@@ -2037,16 +2040,13 @@ extern void print_fields(type_t type, void *object)
 					     (curr_inx == field_count));
 			break;
 		case PRINT_USER:
-		{
-			char *user = NULL;
 			switch(type) {
 			case JOB:
 				if (job->user)
 					tmp_char = job->user;
-				else {
-					user = uid_to_string(job->uid);
-					tmp_char = user;
-				}
+				else
+					tmp_char = uid_to_string_cached(
+						job->uid);
 				break;
 			case JOBCOMP:
 				tmp_char = job_comp->uid_name;
@@ -2058,9 +2058,7 @@ extern void print_fields(type_t type, void *object)
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(user);
 			break;
-		}
 		case PRINT_USERCPU:
 			switch(type) {
 			case JOB:
@@ -2075,12 +2073,12 @@ extern void print_fields(type_t type, void *object)
 				break;
 			}
 
-			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64);
+			tmp_char = _elapsed_time(tmp_uint64, tmp2_uint64,
+						 tmp1, sizeof(tmp1));
 
 			field->print_routine(field,
 					     tmp_char,
 					     (curr_inx == field_count));
-			xfree(tmp_char);
 			break;
 		case PRINT_WCKEY:
 			switch(type) {
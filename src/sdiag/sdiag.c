@@ -213,6 +213,20 @@ static int _print_stats(void)
 		       buf->bf_exit[i]);
 	}
 
+	printf("\nPrologSlurmctld/EpilogSlurmctld stats (microseconds)\n");
+	printf("\tScripts in flight: %u\n", buf->prep_script_inflight);
+	printf("\tTotal scripts: %u\n", buf->prep_script_cnt);
+	printf("\tMax queue wait: %u\n", buf->prep_script_queue_max);
+	if (buf->prep_script_cnt > 0) {
+		printf("\tMean queue wait: %"PRIu64"\n",
+		       buf->prep_script_queue_sum / buf->prep_script_cnt);
+	}
+	printf("\tMax run time: %u\n", buf->prep_script_run_max);
+	if (buf->prep_script_cnt > 0) {
+		printf("\tMean run time: %"PRIu64"\n",
+		       buf->prep_script_run_sum / buf->prep_script_cnt);
+	}
+
 	printf("\nLatency for 1000 calls to gettimeofday(): %d microseconds\n",
 	       buf->gettimeofday_latency);
 
@@ -43,6 +43,7 @@
 #include "src/common/macros.h"
 #include "src/interfaces/select.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 #include "src/sinfo/sinfo.h"
 #include "src/sinfo/print.h"
 #include "src/interfaces/data_parser.h"
@@ -50,7 +51,23 @@
 /********************
  * Global Variables *
  ********************/
+
+/* sinfo_data_t records of one sinfo_list, indexed by their match fields */
+typedef struct {
+	xhash_t *hash;			/* sinfo_group_t by match field key */
+	pthread_mutex_t mutex;		/* protects hash */
+	node_info_msg_t *node_msg;
+	sinfo_data_t **part_empty;	/* per partition records created
+					 * before any node was added */
+} sinfo_groups_t;
+
+typedef struct {
+	char *key;
+	sinfo_data_t *sinfo_ptr;
+} sinfo_group_t;
+
 typedef struct build_part_info {
+	sinfo_groups_t *groups;
 	node_info_msg_t *node_msg;
 	uint16_t part_num;
 	partition_info_t *part_ptr;
@@ -83,13 +100,14 @@ static int  _build_sinfo_data(List sinfo_list,
 			      partition_info_msg_t *partition_msg,
 			      node_info_msg_t *node_msg);
 static sinfo_data_t *_create_sinfo(partition_info_t* part_ptr,
-				   uint16_t part_inx, node_info_t *node_ptr);
+				   uint16_t part_inx, node_info_t *node_ptr,
+				   node_info_msg_t *node_msg);
 static int  _find_part_list(void *x, void *key);
 static bool _filter_out(node_info_t *node_ptr);
 static int _get_info(bool clear_old, slurmdb_federation_rec_t *fed,
 		     char *cluster_name, int argc, char **argv);
-static int  _insert_node_ptr(List sinfo_list, uint16_t part_num,
-			     partition_info_t *part_ptr,
+static int  _insert_node_ptr(List sinfo_list, sinfo_groups_t *groups,
+			     uint16_t part_num, partition_info_t *part_ptr,
 			     node_info_t *node_ptr);
 static int  _load_resv(reserve_info_msg_t ** reserv_pptr, bool clear_old);
 static bool _match_node_data(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr);
@@ -106,7 +124,12 @@ static int  _reservation_report(reserve_info_msg_t *resv_ptr);
 static bool _serial_part_data(void);
 static void _sinfo_list_delete(void *data);
 static void _sort_hostlist(List sinfo_list);
-static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr);
+static void _sinfo_group_free(void *item);
+static int _set_sinfo_nodes(void *x, void *arg);
+static bool _use_group_key(void);
+static void _sinfo_group_id(void *item, const char **key, uint32_t *key_len);
+static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr,
+			  node_info_msg_t *node_msg);
 
 int main(int argc, char **argv)
 {
@@ -541,8 +564,8 @@ void *_build_part_info(void *args)
 			if (node_ptr->name == NULL)
 				continue;
 
-			_insert_node_ptr(sinfo_list, part_num,
-					 part_ptr, node_ptr);
+			_insert_node_ptr(sinfo_list, build_struct_ptr->groups,
+					 part_num, part_ptr, node_ptr);
 		}
 		j += 2;
 	}
@@ -577,19 +600,25 @@ static int _build_sinfo_data(List sinfo_list,
 	build_part_info_t *build_struct_ptr;
 	node_info_t *node_ptr = NULL;
 	partition_info_t *part_ptr = NULL;
+	sinfo_groups_t groups = { .node_msg = node_msg };
 	int j;
 
+	groups.hash = xhash_init(_sinfo_group_id, _sinfo_group_free);
+	slurm_mutex_init(&groups.mutex);
+
 	/* by default every partition is shown, even if no nodes */
 	if ((!params.node_flag) && (params.match_flags & MATCH_FLAG_PARTITION)){
+		groups.part_empty = xcalloc(partition_msg->record_count,
+					    sizeof(sinfo_data_t *));
 		part_ptr = partition_msg->partition_array;
 		for (j = 0; j < partition_msg->record_count; j++, part_ptr++) {
 			if ((!params.part_list) ||
 			    (list_find_first(params.part_list,
 					     _find_part_list,
 					     part_ptr->name))) {
-				list_append(sinfo_list, _create_sinfo(
-						    part_ptr, (uint16_t) j,
-						    NULL));
+				groups.part_empty[j] = _create_sinfo(
+					part_ptr, (uint16_t) j, NULL, NULL);
+				list_append(sinfo_list, groups.part_empty[j]);
 			}
 		}
 	}
@@ -624,13 +653,14 @@ static int _build_sinfo_data(List sinfo_list,
 			hostlist_destroy(hl);
 			if (pos < 0)
 				continue;
-			_insert_node_ptr(sinfo_list, (uint16_t) j,
+			_insert_node_ptr(sinfo_list, &groups, (uint16_t) j,
 					 part_ptr, node_ptr);
 			continue;
 		}
 
 		/* Process each partition using a separate thread */
 		build_struct_ptr = xmalloc(sizeof(build_part_info_t));
+		build_struct_ptr->groups     = &groups;
 		build_struct_ptr->node_msg   = node_msg;
 		build_struct_ptr->part_num   = (uint16_t) j;
 		build_struct_ptr->part_ptr   = part_ptr;
@@ -650,6 +680,11 @@ static int _build_sinfo_data(List sinfo_list,
 	}
 	slurm_mutex_unlock(&sinfo_cnt_mutex);
 
+	xhash_free(groups.hash);
+	slurm_mutex_destroy(&groups.mutex);
+	xfree(groups.part_empty);
+
+	list_for_each(sinfo_list, _set_sinfo_nodes, node_msg);
 	_sort_hostlist(sinfo_list);
 	return SLURM_SUCCESS;
 }
@@ -980,15 +1015,25 @@ static bool _match_part_data(sinfo_data_t *sinfo_ptr,
 	return true;
 }
 
-static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
+static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr,
+			  node_info_msg_t *node_msg)
 {
 	uint32_t base_state;
 	uint64_t alloc_mem = 0;
 	uint16_t used_cpus = 0;
 	int total_cpus = 0;
+	int node_inx = node_ptr - node_msg->node_array;
 
 	base_state = node_ptr->node_state & NODE_STATE_BASE;
 
+	/*
+	 * Grouped records track their nodes in a bitmap and build the
+	 * hostlist once in _set_sinfo_nodes(). With --Node every record holds
+	 * one node, and the other modes match against the hostlist itself.
+	 */
+	if (!sinfo_ptr->node_bitmap && !params.node_flag && _use_group_key())
+		sinfo_ptr->node_bitmap = bit_alloc(node_msg->record_count);
+
 	if (sinfo_ptr->nodes_total == 0) {	/* first node added */
 		sinfo_ptr->node_state = node_ptr->node_state;
 		sinfo_ptr->features   = node_ptr->features;
@@ -1023,7 +1068,9 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 		sinfo_ptr->max_cpus_per_node = sinfo_ptr->part_info->
 					       max_cpus_per_node;
 		sinfo_ptr->version    = node_ptr->version;
-	} else if (hostlist_find(sinfo_ptr->nodes, node_ptr->name) != -1) {
+	} else if (sinfo_ptr->node_bitmap ?
+		   bit_test(sinfo_ptr->node_bitmap, node_inx) :
+		   (hostlist_find(sinfo_ptr->nodes, node_ptr->name) != -1)) {
 		/* we already have this node in this record,
 		 * just return, don't duplicate */
 		return;
@@ -1074,7 +1121,9 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 			sinfo_ptr->max_free_mem = node_ptr->free_mem;
 	}
 
-	if (hostlist_find(sinfo_ptr->nodes, node_ptr->name) == -1)
+	if (sinfo_ptr->node_bitmap)
+		bit_set(sinfo_ptr->node_bitmap, node_inx);
+	else
 		hostlist_push_host(sinfo_ptr->nodes, node_ptr->name);
 	if ((params.match_flags & MATCH_FLAG_NODE_ADDR) &&
 	    (hostlist_find(sinfo_ptr->node_addr, node_ptr->node_addr) == -1))
@@ -1117,31 +1166,238 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 		sinfo_ptr->cpus_idle += total_cpus;
 }
 
-static int _insert_node_ptr(List sinfo_list, uint16_t part_num,
-			    partition_info_t *part_ptr,
+/* Build the hostlist of a grouped record from its node bitmap */
+static int _set_sinfo_nodes(void *x, void *arg)
+{
+	sinfo_data_t *sinfo_ptr = x;
+	node_info_msg_t *node_msg = arg;
+	char *names = NULL, *pos = NULL;
+
+	if (!sinfo_ptr->node_bitmap)
+		return 0;
+
+	for (int i = 0; (i = bit_ffs_from_bit(sinfo_ptr->node_bitmap, i)) >= 0;
+	     i++)
+		xstrfmtcatat(names, &pos, "%s%s", names ? "," : "",
+			     node_msg->node_array[i].name);
+	if (names)
+		hostlist_push(sinfo_ptr->nodes, names);
+	xfree(names);
+	FREE_NULL_BITMAP(sinfo_ptr->node_bitmap);
+
+	return 0;
+}
+
+static void _sinfo_group_id(void *item, const char **key, uint32_t *key_len)
+{
+	sinfo_group_t *group = item;
+
+	*key = group->key;
+	*key_len = strlen(group->key);
+}
+
+static void _sinfo_group_free(void *item)
+{
+	sinfo_group_t *group = item;
+
+	xfree(group->key);
+	xfree(group);
+}
+
+/* Append a length prefixed string so that keys can not collide */
+static void _key_add_str(char **key, const char *str)
+{
+	if (str)
+		xstrfmtcat(*key, "%zu:%s|", strlen(str), str);
+	else
+		xstrcat(*key, "-|");
+}
+
+/*
+ * Build a key from every field compared by _match_part_data() and
+ * _match_node_data(), so nodes that would be combined into the same sinfo
+ * record have identical keys.
+ */
+static char *_sinfo_group_key(partition_info_t *part_ptr,
+			      node_info_t *node_ptr)
+{
+	char *key = NULL;
+	uint64_t alloc_mem = 0;
+
+	/*
+	 * _match_node_data() never merges nodes with --Node, so every node of
+	 * each partition gets its own record.
+	 */
+	if (params.node_flag)
+		xstrfmtcat(key, "%s|%s|#", part_ptr->name, node_ptr->name);
+
+	if (params.match_flags & MATCH_FLAG_PARTITION)
+		_key_add_str(&key, part_ptr->name);
+	if (params.match_flags & MATCH_FLAG_AVAIL)
+		xstrfmtcat(key, "%u|", part_ptr->state_up);
+	if (params.match_flags & MATCH_FLAG_GROUPS)
+		_key_add_str(&key, part_ptr->allow_groups);
+	if (params.match_flags & MATCH_FLAG_JOB_SIZE)
+		xstrfmtcat(key, "%u|%u|", part_ptr->min_nodes,
+			   part_ptr->max_nodes);
+	if (params.match_flags & MATCH_FLAG_DEFAULT_TIME)
+		xstrfmtcat(key, "%u|", part_ptr->default_time);
+	if (params.match_flags & MATCH_FLAG_MAX_TIME)
+		xstrfmtcat(key, "%u|", part_ptr->max_time);
+	if (params.match_flags & MATCH_FLAG_ROOT)
+		xstrfmtcat(key, "%u|", (part_ptr->flags & PART_FLAG_ROOT_ONLY) ?
+			   1 : 0);
+	if (params.match_flags & MATCH_FLAG_OVERSUBSCRIBE)
+		xstrfmtcat(key, "%u|", part_ptr->max_share);
+	if (params.match_flags & MATCH_FLAG_PREEMPT_MODE)
+		xstrfmtcat(key, "%u|", part_ptr->preempt_mode);
+	if (params.match_flags & MATCH_FLAG_PRIORITY_TIER)
+		xstrfmtcat(key, "%u|", part_ptr->priority_tier);
+	if (params.match_flags & MATCH_FLAG_PRIORITY_JOB_FACTOR)
+		xstrfmtcat(key, "%u|", part_ptr->priority_job_factor);
+	if (params.match_flags & MATCH_FLAG_MAX_CPUS_PER_NODE)
+		xstrfmtcat(key, "%u|", part_ptr->max_cpus_per_node);
+
+	xstrcat(key, "#");
+
+	if (params.match_flags & MATCH_FLAG_EXTRA)
+		_key_add_str(&key, node_ptr->extra);
+	if (params.match_flags & MATCH_FLAG_FEATURES)
+		_key_add_str(&key, node_ptr->features);
+	if (params.match_flags & MATCH_FLAG_FEATURES_ACT)
+		_key_add_str(&key, node_ptr->features_act);
+	if (params.match_flags & MATCH_FLAG_GRES)
+		_key_add_str(&key, node_ptr->gres);
+	if (params.match_flags & MATCH_FLAG_GRES_USED)
+		_key_add_str(&key, node_ptr->gres_used);
+	if (params.match_flags & MATCH_FLAG_COMMENT)
+		_key_add_str(&key, node_ptr->comment);
+	if (params.match_flags & MATCH_FLAG_REASON)
+		_key_add_str(&key, node_ptr->reason);
+	if (params.match_flags & MATCH_FLAG_REASON_TIMESTAMP)
+		xstrfmtcat(key, "%ld|", (long) node_ptr->reason_time);
+	if (params.match_flags & MATCH_FLAG_REASON_USER)
+		xstrfmtcat(key, "%u|", node_ptr->reason_uid);
+	if (params.match_flags & MATCH_FLAG_RESV_NAME)
+		_key_add_str(&key, node_ptr->resv_name);
+	if (params.match_flags & MATCH_FLAG_STATE)
+		_key_add_str(&key, node_state_string(node_ptr->node_state));
+	if (params.match_flags & MATCH_FLAG_STATE_COMPLETE) {
+		char *state = node_state_string_complete(node_ptr->node_state);
+		_key_add_str(&key, state);
+		xfree(state);
+	}
+	if (params.match_flags & MATCH_FLAG_ALLOC_MEM) {
+		select_g_select_nodeinfo_get(node_ptr->select_nodeinfo,
+					     SELECT_NODEDATA_MEM_ALLOC,
+					     NODE_STATE_ALLOCATED,
+					     &alloc_mem);
+		xstrfmtcat(key, "%"PRIu64"|", alloc_mem);
+	}
+
+	if (!params.exact_match)
+		return key;
+
+	if (params.match_flags & MATCH_FLAG_CPUS)
+		xstrfmtcat(key, "%u|", node_ptr->cpus);
+	if (params.match_flags & (MATCH_FLAG_SOCKETS | MATCH_FLAG_SCT))
+		xstrfmtcat(key, "%u|", node_ptr->sockets);
+	if (params.match_flags & (MATCH_FLAG_CORES | MATCH_FLAG_SCT))
+		xstrfmtcat(key, "%u|", node_ptr->cores);
+	if (params.match_flags & (MATCH_FLAG_THREADS | MATCH_FLAG_SCT))
+		xstrfmtcat(key, "%u|", node_ptr->threads);
+	if (params.match_flags & MATCH_FLAG_DISK)
+		xstrfmtcat(key, "%u|", node_ptr->tmp_disk);
+	if (params.match_flags & MATCH_FLAG_MEMORY)
+		xstrfmtcat(key, "%"PRIu64"|", node_ptr->real_memory);
+	if (params.match_flags & MATCH_FLAG_WEIGHT)
+		xstrfmtcat(key, "%u|", node_ptr->weight);
+	if (params.match_flags & MATCH_FLAG_CPU_LOAD)
+		xstrfmtcat(key, "%u|", node_ptr->cpu_load);
+	if (params.match_flags & MATCH_FLAG_FREE_MEM)
+		xstrfmtcat(key, "%"PRIu64"|", node_ptr->free_mem);
+	if (params.match_flags & MATCH_FLAG_PORT)
+		xstrfmtcat(key, "%u|", node_ptr->port);
+	/* _match_node_data() compares the version pointers */
+	if (params.match_flags & MATCH_FLAG_VERSION)
+		xstrfmtcat(key, "%p|", node_ptr->version);
+
+	return key;
+}
+
+/*
+ * Return true if nodes can be grouped by _sinfo_group_key(). Hostnames and
+ * node addresses are matched by membership in the record's hostlist rather
+ * than equality, and list_reasons matches any partition record, so those
+ * fall back to scanning sinfo_list.
+ */
+static bool _use_group_key(void)
+{
+	if (params.list_reasons)
+		return false;
+	if (params.match_flags & (MATCH_FLAG_HOSTNAMES | MATCH_FLAG_NODE_ADDR))
+		return false;
+	return true;
+}
+
+static int _insert_node_ptr(List sinfo_list, sinfo_groups_t *groups,
+			    uint16_t part_num, partition_info_t *part_ptr,
 			    node_info_t *node_ptr)
 {
 	int rc = SLURM_SUCCESS;
 	sinfo_data_t *sinfo_ptr = NULL;
+	sinfo_group_t *group;
 	list_itr_t *itr = NULL;
+	char *key;
 
-	itr = list_iterator_create(sinfo_list);
-	while ((sinfo_ptr = list_next(itr))) {
-		if (!_match_part_data(sinfo_ptr, part_ptr))
-			continue;
-		if (sinfo_ptr->nodes_total &&
-		    (!_match_node_data(sinfo_ptr, node_ptr)))
-			continue;
-		_update_sinfo(sinfo_ptr, node_ptr);
-		break;
+	if (!_use_group_key()) {
+		itr = list_iterator_create(sinfo_list);
+		while ((sinfo_ptr = list_next(itr))) {
+			if (!_match_part_data(sinfo_ptr, part_ptr))
+				continue;
+			if (sinfo_ptr->nodes_total &&
+			    (!_match_node_data(sinfo_ptr, node_ptr)))
+				continue;
+			_update_sinfo(sinfo_ptr, node_ptr, groups->node_msg);
+			break;
+		}
+		list_iterator_destroy(itr);
+
+		/* if no match, create new sinfo_data entry */
+		if (!sinfo_ptr) {
+			list_append(sinfo_list,
+				    _create_sinfo(part_ptr, part_num, node_ptr,
+						  groups->node_msg));
+		}
+		return rc;
 	}
-	list_iterator_destroy(itr);
 
-	/* if no match, create new sinfo_data entry */
-	if (!sinfo_ptr) {
-		list_append(sinfo_list,
-			    _create_sinfo(part_ptr, part_num, node_ptr));
+	key = _sinfo_group_key(part_ptr, node_ptr);
+
+	slurm_mutex_lock(&groups->mutex);
+	if ((group = xhash_get_str(groups->hash, key))) {
+		_update_sinfo(group->sinfo_ptr, node_ptr, groups->node_msg);
+		xfree(key);
+	} else {
+		/*
+		 * The record created for this partition before any nodes
+		 * were added takes the partition's first node.
+		 */
+		if (groups->part_empty && groups->part_empty[part_num] &&
+		    !groups->part_empty[part_num]->nodes_total) {
+			sinfo_ptr = groups->part_empty[part_num];
+			_update_sinfo(sinfo_ptr, node_ptr, groups->node_msg);
+		} else {
+			sinfo_ptr = _create_sinfo(part_ptr, part_num, node_ptr,
+						  groups->node_msg);
+			list_append(sinfo_list, sinfo_ptr);
+		}
+		group = xmalloc(sizeof(*group));
+		group->key = key;
+		group->sinfo_ptr = sinfo_ptr;
+		xhash_add(groups->hash, group);
 	}
+	slurm_mutex_unlock(&groups->mutex);
 
 	return rc;
 }
@@ -1152,9 +1408,11 @@ static int _insert_node_ptr(List sinfo_list, uint16_t part_num,
  * part_ptr IN       - pointer to partition record to add
  * part_inx IN       - index of partition record (0-origin)
  * node_ptr IN       - pointer to node record to add
+ * node_msg IN       - node info message containing node_ptr
  */
 static sinfo_data_t *_create_sinfo(partition_info_t* part_ptr,
-				   uint16_t part_inx, node_info_t *node_ptr)
+				   uint16_t part_inx, node_info_t *node_ptr,
+				   node_info_msg_t *node_msg)
 {
 	sinfo_data_t *sinfo_ptr;
 	/* create an entry */
@@ -1167,7 +1425,7 @@ static sinfo_data_t *_create_sinfo(partition_info_t* part_ptr,
 	sinfo_ptr->hostnames = hostlist_create(NULL);
 
 	if (node_ptr)
-		_update_sinfo(sinfo_ptr, node_ptr);
+		_update_sinfo(sinfo_ptr, node_ptr, node_msg);
 
 	return sinfo_ptr;
 }
@@ -1193,6 +1451,7 @@ static void _sinfo_list_delete(void *data)
 	hostlist_destroy(sinfo_ptr->nodes);
 	hostlist_destroy(sinfo_ptr->node_addr);
 	hostlist_destroy(sinfo_ptr->hostnames);
+	FREE_NULL_BITMAP(sinfo_ptr->node_bitmap);
 	xfree(sinfo_ptr);
 }
 
@@ -51,6 +51,7 @@
 
 #include "slurm/slurm.h"
 
+#include "src/common/bitstring.h"
 #include "src/common/hostlist.h"
 #include "src/common/list.h"
 #include "src/common/log.h"
@@ -112,6 +113,7 @@ typedef struct {
 	hostlist_t *hostnames;
 	hostlist_t *node_addr;
 	hostlist_t *nodes;
+	bitstr_t *node_bitmap;	/* node_msg indexes of nodes in this record */
 
 	/* part_info contains partition, avail, max_time, job_size,
 	 * root, share/oversubscribe, groups, priority */
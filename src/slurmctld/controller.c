@@ -115,6 +115,7 @@
 #include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/licenses.h"
 #include "src/slurmctld/locks.h"
+#include "src/slurmctld/node_scheduler.h"
 #include "src/slurmctld/ping_nodes.h"
 #include "src/slurmctld/port_mgr.h"
 #include "src/slurmctld/power_save.h"
@@ -713,6 +714,7 @@ int main(int argc, char **argv)
 		_slurmctld_background(NULL);
 
 		controller_fini_scheduling(); /* Stop all scheduling */
+		reboot_job_nodes_fini();
 		agent_fini();
 
 		/* termination of controller */
@@ -816,6 +818,7 @@ int main(int argc, char **argv)
 	/* Purge our local data structures */
 	configless_clear();
 	job_fini();
+	node_scheduler_fini();
 	part_fini();	/* part_fini() must precede node_fini() */
 	node_fini();
 	mpi_fini();
@@ -2229,6 +2232,9 @@ static void *_slurmctld_background(void *no_data)
 			unlock_slurmctld(node_write_lock);
 		}
 
+		/* Send node reboots batched outside of the main scheduler */
+		reboot_job_nodes_flush();
+
 		/* Process any pending agent work */
 		agent_trigger(RPC_RETRY_INTERVAL, true, true);
 
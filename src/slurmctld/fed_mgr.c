@@ -2559,6 +2559,137 @@ static void *_fed_job_update_thread(void *arg)
 	return NULL;
 }
 
+/* RPCs of one sibling that are due in the current fed agent round */
+typedef struct {
+	slurmdb_cluster_rec_t *cluster;
+	list_t *buffers;		/* packed RPCs to combine */
+	time_t now;			/* last_try of the RPCs sent */
+	pthread_t tid;
+} agent_send_t;
+
+/*
+ * Collect the buffers of all RPCs queued for a sibling which are not being
+ * deferred after a failed try. Return NULL if there are none.
+ * Caller must hold the fed read lock.
+ */
+static list_t *_agent_due_rpcs(slurmdb_cluster_rec_t *cluster, time_t now)
+{
+	list_itr_t *rpc_iter;
+	agent_queue_t *rpc_rec;
+	list_t *buffers = NULL;
+
+	rpc_iter = list_iterator_create(cluster->send_rpc);
+	while ((rpc_rec = list_next(rpc_iter))) {
+		if ((rpc_rec->last_try + rpc_rec->last_defer) >= now)
+			continue;
+		if (!buffers)
+			buffers = list_create(NULL);
+		list_append(buffers, rpc_rec->buffer);
+		rpc_rec->last_try = now;
+		if (rpc_rec->last_defer == 128) {
+			info("%s: %s JobId=%u request to cluster %s is repeatedly failing",
+			     __func__, rpc_num2string(rpc_rec->msg_type),
+			     rpc_rec->job_id, cluster->name);
+			rpc_rec->last_defer *= 2;
+		} else if (rpc_rec->last_defer)
+			rpc_rec->last_defer *= 2;
+		else
+			rpc_rec->last_defer = 2;
+	}
+	list_iterator_destroy(rpc_iter);
+
+	return buffers;
+}
+
+/*
+ * Send the due RPCs of one sibling as a single combined RPC and remove the
+ * ones the sibling processed from its queue.
+ * Caller must hold the fed read lock.
+ */
+static void _agent_send_cluster(agent_send_t *send)
+{
+	slurmdb_cluster_rec_t *cluster = send->cluster;
+	list_itr_t *rpc_iter;
+	agent_queue_t *rpc_rec;
+	slurm_msg_t req_msg, resp_msg;
+	ctld_list_msg_t ctld_req_msg;
+	bitstr_t *success_bits;
+	int rc, resp_inx, success_size;
+	time_t now = send->now;
+
+	ctld_req_msg.my_list = send->buffers;
+	send->buffers = NULL;
+
+	/* Build, pack and send the combined RPC */
+	slurm_msg_t_init(&req_msg);
+	req_msg.msg_type = REQUEST_CTLD_MULT_MSG;
+	req_msg.data     = &ctld_req_msg;
+	rc = _send_recv_msg(cluster, &req_msg, &resp_msg, false);
+
+	/* Process the response */
+	if ((rc == SLURM_SUCCESS) &&
+	    (resp_msg.msg_type == RESPONSE_CTLD_MULT_MSG)) {
+		/* Remove successfully processed RPCs */
+		resp_inx = 0;
+		success_bits = _parse_resp_ctld_mult(&resp_msg);
+		success_size = bit_size(success_bits);
+		rpc_iter = list_iterator_create(cluster->send_rpc);
+		while ((rpc_rec = list_next(rpc_iter))) {
+			if (rpc_rec->last_try != now)
+				continue;
+			if (resp_inx >= success_size) {
+				error("%s: bitmap too small (%d >= %d)",
+				      __func__, resp_inx, success_size);
+				break;
+			}
+			if (bit_test(success_bits, resp_inx++))
+				list_delete_item(rpc_iter);
+		}
+		list_iterator_destroy(rpc_iter);
+		FREE_NULL_BITMAP(success_bits);
+	} else {
+		/* Failed to process combined RPC.
+		 * Leave all RPCs on the queue. */
+		if (rc != SLURM_SUCCESS) {
+			if (_comm_fail_log(cluster)) {
+				error("%s: Failed to send RPC: %s",
+				      __func__, slurm_strerror(rc));
+			} else {
+				debug("%s: Failed to send RPC: %s",
+				      __func__, slurm_strerror(rc));
+			}
+		} else if (resp_msg.msg_type == PERSIST_RC) {
+			persist_rc_msg_t *msg;
+			char *err_str;
+			msg = resp_msg.data;
+			if (msg->comment)
+				err_str = msg->comment;
+			else
+				err_str = slurm_strerror(msg->rc);
+			error("%s: failed to process msg: %s",
+			      __func__, err_str);
+		} else if (resp_msg.msg_type == RESPONSE_SLURM_RC) {
+			rc = slurm_get_return_code(resp_msg.msg_type,
+						   resp_msg.data);
+			error("%s: failed to process msg: %s",
+			      __func__, slurm_strerror(rc));
+		} else {
+			error("%s: Invalid response msg_type: %u",
+			      __func__, resp_msg.msg_type);
+		}
+	}
+	(void) slurm_free_msg_data(resp_msg.msg_type, resp_msg.data);
+
+	FREE_NULL_LIST(ctld_req_msg.my_list);
+}
+
+static void *_agent_cluster_thread(void *arg)
+{
+	_agent_send_cluster(arg);
+
+	return NULL;
+}
+
 /* Start a thread to manage queued agent requests */
 static void *_agent_thread(void *arg)
 {
@@ -2566,10 +2697,10 @@ static void *_agent_thread(void *arg)
 	struct timespec ts = {0, 0};
 	list_itr_t *cluster_iter, *rpc_iter;
 	agent_queue_t *rpc_rec;
-	slurm_msg_t req_msg, resp_msg;
-	ctld_list_msg_t ctld_req_msg;
-	bitstr_t *success_bits;
-	int rc, resp_inx, success_size;
+	agent_send_t *sends = NULL;
+	list_t *buffers;
+	int send_cnt, send_max = 0;
+	time_t now;
 
 	slurmctld_lock_t fed_read_lock = {
 		NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK, READ_LOCK };
@@ -2599,117 +2730,52 @@ static void *_agent_thread(void *arg)
 		}
 
 		/* Look for work on each cluster */
+		now = time(NULL);
+		send_cnt = 0;
 		cluster_iter = list_iterator_create(
 					fed_mgr_fed_rec->cluster_list);
-		while (!slurmctld_config.shutdown_time &&
-		       (cluster = list_next(cluster_iter))) {
-			time_t now = time(NULL);
+		while ((cluster = list_next(cluster_iter))) {
 			if ((cluster->send_rpc == NULL) ||
 			   (list_count(cluster->send_rpc) == 0))
 				continue;
-
-			/* Move currently pending RPCs to new list */
-			ctld_req_msg.my_list = NULL;
-			rpc_iter = list_iterator_create(cluster->send_rpc);
-			while ((rpc_rec = list_next(rpc_iter))) {
-				if ((rpc_rec->last_try + rpc_rec->last_defer) >=
-				    now)
-					continue;
-				if (!ctld_req_msg.my_list)
-					ctld_req_msg.my_list =list_create(NULL);
-				list_append(ctld_req_msg.my_list,
-					    rpc_rec->buffer);
-				rpc_rec->last_try = now;
-				if (rpc_rec->last_defer == 128) {
-					info("%s: %s JobId=%u request to cluster %s is repeatedly failing",
-					     __func__,
-					     rpc_num2string(rpc_rec->msg_type),
-					     rpc_rec->job_id, cluster->name);
-					rpc_rec->last_defer *= 2;
-				} else if (rpc_rec->last_defer)
-					rpc_rec->last_defer *= 2;
-				else
-					rpc_rec->last_defer = 2;
-			}
-			list_iterator_destroy(rpc_iter);
-			if (!ctld_req_msg.my_list)
+			if (!(buffers = _agent_due_rpcs(cluster, now)))
 				continue;
-
-			/* Build, pack and send the combined RPC */
-			slurm_msg_t_init(&req_msg);
-			req_msg.msg_type = REQUEST_CTLD_MULT_MSG;
-			req_msg.data     = &ctld_req_msg;
-			rc = _send_recv_msg(cluster, &req_msg, &resp_msg,
-					    false);
-
-			/* Process the response */
-			if ((rc == SLURM_SUCCESS) &&
-			    (resp_msg.msg_type == RESPONSE_CTLD_MULT_MSG)) {
-				/* Remove successfully processed RPCs */
-				resp_inx = 0;
-				success_bits = _parse_resp_ctld_mult(&resp_msg);
-				success_size = bit_size(success_bits);
-				rpc_iter = list_iterator_create(cluster->
-								send_rpc);
-				while ((rpc_rec = list_next(rpc_iter))) {
-					if (rpc_rec->last_try != now)
-						continue;
-					if (resp_inx >= success_size) {
-						error("%s: bitmap too small (%d >= %d)",
-						      __func__, resp_inx,
-						      success_size);
-						break;
-					}
-					if (bit_test(success_bits, resp_inx++))
-						list_delete_item(rpc_iter);
-				}
-				list_iterator_destroy(rpc_iter);
-				FREE_NULL_BITMAP(success_bits);
-			} else {
-				/* Failed to process combined RPC.
-				 * Leave all RPCs on the queue. */
-				if (rc != SLURM_SUCCESS) {
-					if (_comm_fail_log(cluster)) {
-						error("%s: Failed to send RPC: %s",
-						      __func__,
-						      slurm_strerror(rc));
-					} else {
-						debug("%s: Failed to send RPC: %s",
-						      __func__,
-						      slurm_strerror(rc));
-					}
-				} else if (resp_msg.msg_type ==
-					   PERSIST_RC) {
-					persist_rc_msg_t *msg;
-					char *err_str;
-					msg = resp_msg.data;
-					if (msg->comment)
-						err_str = msg->comment;
-					else
-						err_str=slurm_strerror(msg->rc);
-					error("%s: failed to process msg: %s",
-					      __func__, err_str);
-				} else if (resp_msg.msg_type ==
-					   RESPONSE_SLURM_RC) {
-					rc = slurm_get_return_code(
-						resp_msg.msg_type,
-						resp_msg.data);
-					error("%s: failed to process msg: %s",
-					      __func__, slurm_strerror(rc));
-				} else {
-					error("%s: Invalid response msg_type: %u",
-					      __func__, resp_msg.msg_type);
-				}
+			if (send_cnt >= send_max) {
+				send_max = send_cnt + 4;
+				xrecalloc(sends, send_max, sizeof(*sends));
 			}
-			(void) slurm_free_msg_data(resp_msg.msg_type,
-						   resp_msg.data);
-
-			FREE_NULL_LIST(ctld_req_msg.my_list);
+			sends[send_cnt].cluster = cluster;
+			sends[send_cnt].buffers = buffers;
+			sends[send_cnt].now = now;
+			sends[send_cnt].tid = 0;
+			send_cnt++;
 		}
 		list_iterator_destroy(cluster_iter);
 
+		/*
+		 * Each sibling has its own persistent connection, so talk to
+		 * all of them at once rather than paying one round trip after
+		 * another. The last one is handled by this thread. RPCs not
+		 * sent because of shutdown stay queued and are logged below.
+		 */
+		for (int i = 0; i < send_cnt; i++) {
+			if (slurmctld_config.shutdown_time)
+				FREE_NULL_LIST(sends[i].buffers);
+			else if (i == (send_cnt - 1))
+				_agent_send_cluster(&sends[i]);
+			else
+				slurm_thread_create(&sends[i].tid,
+						    _agent_cluster_thread,
+						    &sends[i]);
+		}
+		for (int i = 0; i < send_cnt; i++) {
+			if (sends[i].tid)
+				slurm_thread_join(sends[i].tid);
+		}
+
 		unlock_slurmctld(fed_read_lock);
 	}
+	xfree(sends);
 
 	/* Log the abandoned RPCs */
 	lock_slurmctld(fed_read_lock);
@@ -5462,9 +5528,31 @@ extern int fed_mgr_update_job_cluster_features(job_record_t *job_ptr,
 	return rc;
 }
 
+static int _cmp_job_id(uint32_t job_id1, uint32_t job_id2)
+{
+	if (job_id1 < job_id2)
+		return -1;
+	if (job_id1 > job_id2)
+		return 1;
+	return 0;
+}
+
+static int _sort_remote_job_id(const void *x, const void *y)
+{
+	const slurm_job_info_t *job1 = x, *job2 = y;
+
+	return _cmp_job_id(job1->job_id, job2->job_id);
+}
+
+static int _find_remote_job_id(const void *key, const void *x)
+{
+	const slurm_job_info_t *job = x;
+
+	return _cmp_job_id(*(const uint32_t *) key, job->job_id);
+}
+
 static int _reconcile_fed_job(job_record_t *job_ptr, reconcile_sib_t *rec_sib)
 {
-	int i;
 	bool found_job = false;
 	job_info_msg_t *remote_jobs_ptr = rec_sib->job_info_msg;
 	uint32_t origin_id    = fed_mgr_get_cluster_id(job_ptr->job_id);
@@ -5493,13 +5581,12 @@ static int _reconcile_fed_job(job_record_t *job_ptr, reconcile_sib_t *rec_sib)
 		return SLURM_SUCCESS;
 	}
 
-	for (i = 0; i < remote_jobs_ptr->record_count; i++) {
-		remote_job = &remote_jobs_ptr->job_array[i];
-		if (job_ptr->job_id == remote_job->job_id) {
-			found_job = true;
-			break;
-		}
-	}
+	/* job_array was sorted by job_id in _sync_jobs() */
+	remote_job = bsearch(&job_ptr->job_id, remote_jobs_ptr->job_array,
+			     remote_jobs_ptr->record_count,
+			     sizeof(slurm_job_info_t), _find_remote_job_id);
+	if (remote_job)
+		found_job = true;
 
 	/* Jobs that originated on the remote sibling */
 	if (origin_id == sibling_id) {
@@ -5752,6 +5839,11 @@ static int _sync_jobs(const char *sib_name, job_info_msg_t *job_info_msg,
 	rec_sib.job_info_msg = job_info_msg;
 	rec_sib.sync_time    = sync_time;
 
+	/* Every local federated job is looked up in the sibling's list */
+	if (job_info_msg->record_count > 1)
+		qsort(job_info_msg->job_array, job_info_msg->record_count,
+		      sizeof(slurm_job_info_t), _sort_remote_job_id);
+
 	itr = list_iterator_create(job_list);
 	while ((job_ptr = list_next(itr)))
 		_reconcile_fed_job(job_ptr, &rec_sib);
@@ -4475,6 +4475,8 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	job_ptr_pend->container = xstrdup(job_ptr->container);
 	job_ptr_pend->container_id = xstrdup(job_ptr->container_id);
 	job_ptr_pend->extra = xstrdup(job_ptr->extra);
+	job_ptr_pend->extra_pass_bitmap = NULL;
+	job_ptr_pend->extra_tested_bitmap = NULL;
 
 	job_ptr_pend->fed_details = _dup_job_fed_details(job_ptr->fed_details);
 
@@ -9935,6 +9937,8 @@ extern void job_mgr_list_delete_job(void *job_entry)
 	xfree(job_ptr->cpus_per_tres);
 	xfree(job_ptr->extra);
 	FREE_NULL_EXTRA_CONSTRAINTS(job_ptr->extra_constraints);
+	FREE_NULL_BITMAP(job_ptr->extra_pass_bitmap);
+	FREE_NULL_BITMAP(job_ptr->extra_tested_bitmap);
 	xfree(job_ptr->failed_node);
 	free_job_fed_details(&job_ptr->fed_details);
 	free_job_resources(&job_ptr->job_resrcs);
@@ -12661,6 +12665,7 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 			job_ptr->extra = xstrdup(job_desc->extra);
 			FREE_NULL_EXTRA_CONSTRAINTS(job_ptr->extra_constraints);
 			job_ptr->extra_constraints = head;
+			FREE_NULL_BITMAP(job_ptr->extra_tested_bitmap);
 			info("%s: setting extra to %s for %pJ",
 			     __func__, job_ptr->extra, job_ptr);
 		}
@@ -2038,6 +2038,7 @@ fail_this_part:	if (fail_by_part) {
 	_do_diag_stats(DELTA_TIMER);
 
 out:
+	reboot_job_nodes_flush();
 	return job_cnt;
 }
 
@@ -4324,32 +4325,127 @@ extern void reboot_job_nodes(job_record_t *job_ptr)
 {
 	return;
 }
+
+extern void reboot_job_nodes_flush(void)
+{
+	return;
+}
+
+extern void reboot_job_nodes_fini(void)
+{
+	return;
+}
 #else
+/*
+ * Reboot requests are accumulated here while scheduling and sent by
+ * reboot_job_nodes_flush(), so that many jobs starting in the same cycle
+ * with the same reboot features produce a single agent request.
+ */
+typedef struct {
+	char *features;
+	hostlist_t *hostlist;
+	uint16_t protocol_version;
+} reboot_batch_t;
+
+static List reboot_batch_list = NULL;
+static pthread_mutex_t reboot_batch_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void _reboot_batch_destroy(void *x)
+{
+	reboot_batch_t *batch = x;
+
+	if (!batch)
+		return;
+	xfree(batch->features);
+	FREE_NULL_HOSTLIST(batch->hostlist);
+	xfree(batch);
+}
+
+static int _find_reboot_batch(void *x, void *key)
+{
+	reboot_batch_t *batch = x, *match = key;
+
+	if ((batch->protocol_version == match->protocol_version) &&
+	    !xstrcmp(batch->features, match->features))
+		return 1;
+	return 0;
+}
+
 static void _send_reboot_msg(bitstr_t *node_bitmap, char *features,
 			     uint16_t protocol_version)
 {
-	agent_arg_t *reboot_agent_args = NULL;
-	reboot_msg_t *reboot_msg;
+	reboot_batch_t key = {
+		.features = features,
+		.protocol_version = protocol_version,
+	};
+	reboot_batch_t *batch;
 	hostlist_t *hostlist;
 
+	if (!(hostlist = bitmap2hostlist(node_bitmap)))
+		return;
+
+	slurm_mutex_lock(&reboot_batch_mutex);
+	if (!reboot_batch_list)
+		reboot_batch_list = list_create(_reboot_batch_destroy);
+	if ((batch = list_find_first(reboot_batch_list, _find_reboot_batch,
+				     &key))) {
+		hostlist_push_list(batch->hostlist, hostlist);
+		FREE_NULL_HOSTLIST(hostlist);
+	} else {
+		batch = xmalloc(sizeof(*batch));
+		batch->features = xstrdup(features);
+		batch->hostlist = hostlist;
+		batch->protocol_version = protocol_version;
+		list_append(reboot_batch_list, batch);
+	}
+	slurm_mutex_unlock(&reboot_batch_mutex);
+}
+
+static int _queue_reboot_batch(void *x, void *arg)
+{
+	reboot_batch_t *batch = x;
+	agent_arg_t *reboot_agent_args;
+	reboot_msg_t *reboot_msg;
+
+	hostlist_uniq(batch->hostlist);
+
 	reboot_agent_args = xmalloc(sizeof(agent_arg_t));
 	reboot_agent_args->msg_type = REQUEST_REBOOT_NODES;
 	reboot_agent_args->retry = 0;
-	reboot_agent_args->node_count = 0;
-	reboot_agent_args->protocol_version = protocol_version;
-
-	if ((hostlist = bitmap2hostlist(node_bitmap))) {
-		reboot_agent_args->hostlist = hostlist;
-		reboot_agent_args->node_count = hostlist_count(hostlist);
-	}
+	reboot_agent_args->protocol_version = batch->protocol_version;
+	reboot_agent_args->hostlist = batch->hostlist;
+	reboot_agent_args->node_count = hostlist_count(batch->hostlist);
+	batch->hostlist = NULL;
 
 	reboot_msg = xmalloc(sizeof(reboot_msg_t));
 	slurm_init_reboot_msg(reboot_msg, false);
 	reboot_agent_args->msg_args = reboot_msg;
-	reboot_msg->features = xstrdup(features);
+	reboot_msg->features = batch->features;
+	batch->features = NULL;
 
 	set_agent_arg_r_uid(reboot_agent_args, SLURM_AUTH_UID_ANY);
 	agent_queue_request(reboot_agent_args);
+
+	return 1;	/* Remove from list */
+}
+
+extern void reboot_job_nodes_flush(void)
+{
+	slurm_mutex_lock(&reboot_batch_mutex);
+	if (reboot_batch_list)
+		(void) list_delete_all(reboot_batch_list, _queue_reboot_batch,
+				       NULL);
+	slurm_mutex_unlock(&reboot_batch_mutex);
+}
+
+extern void reboot_job_nodes_fini(void)
+{
+	slurm_mutex_lock(&reboot_batch_mutex);
+	if (reboot_batch_list)
+		(void) list_delete_all(reboot_batch_list, _queue_reboot_batch,
+				       NULL);
+	FREE_NULL_LIST(reboot_batch_list);
+	slurm_mutex_unlock(&reboot_batch_mutex);
 }
 
 static void _do_reboot(bool power_save_on, bitstr_t *node_bitmap,
@@ -212,6 +212,18 @@ extern void prolog_slurmctld(job_record_t *job_ptr);
  */
 extern void reboot_job_nodes(job_record_t *job_ptr);
 
+/*
+ * reboot_job_nodes_flush - Send the reboot requests accumulated by
+ *	reboot_job_nodes(), one agent request per distinct feature set.
+ */
+extern void reboot_job_nodes_flush(void);
+
+/*
+ * reboot_job_nodes_fini - Send any reboot requests still accumulated and
+ *	free the reboot batch list. Called once scheduling has stopped.
+ */
+extern void reboot_job_nodes_fini(void);
+
 /* If a job can run in multiple partitions, make sure that the one
  * actually used is first in the string. Needed for job state save/restore */
 extern void rebuild_job_part_list(job_record_t *job_ptr);
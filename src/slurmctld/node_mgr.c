@@ -115,6 +115,11 @@ bitstr_t *power_node_bitmap = NULL;	/* bitmap of powered down nodes */
 bitstr_t *rs_node_bitmap    = NULL; 	/* bitmap of resuming nodes */
 bitstr_t *share_node_bitmap = NULL;  	/* bitmap of sharable nodes */
 bitstr_t *up_node_bitmap    = NULL;  	/* bitmap of non-down nodes */
+uint32_t node_extra_epoch = 0;		/* bumped when any node's extra_data
+					 * changes */
+uint32_t part_config_epoch = 0;		/* bumped when config_list, a
+					 * config_record's node_bitmap or a
+					 * partition's node_bitmap changes */
 
 static int _delete_node_ptr(node_record_t *node_ptr);
 static void 	_dump_node_state(node_record_t *dump_node_ptr, buf_t *buffer);
@@ -274,6 +279,8 @@ int dump_all_node_state ( void )
 
 static void _queue_consolidate_config_list(void)
 {
+	/* Every caller just added to config_list or split a record of it */
+	part_config_epoch++;
 	slurm_mutex_lock(&config_list_update_mutex);
 	config_list_update = true;
 	slurm_mutex_unlock(&config_list_update_mutex);
@@ -958,6 +965,7 @@ static void _combine_dup_config_records(config_record_t *curr_rec)
 			continue;
 
 		changed = true;
+		part_config_epoch++;
 		bit_or(curr_rec->node_bitmap, config_ptr->node_bitmap);
 		list_delete_item(iter);
 	}
@@ -1767,6 +1775,7 @@ int update_node(update_node_msg_t *update_node_msg, uid_t auth_uid)
 			} else {
 				FREE_NULL_DATA(node_ptr->extra_data);
 				node_ptr->extra_data = data;
+				node_extra_epoch++;
 				xfree(node_ptr->extra);
 				if (update_node_msg->extra[0]) {
 					node_ptr->extra =
@@ -2249,6 +2258,7 @@ int update_node(update_node_msg_t *update_node_msg, uid_t auth_uid)
 		if (error_code == SLURM_SUCCESS) {
 			/* sort config_list by weight for scheduling */
 			list_sort(config_list, &list_compare_config);
+			part_config_epoch++;
 		}
 	}
 
@@ -2305,6 +2315,7 @@ extern void restore_node_features(int recover)
 				     node_ptr->extra, node_ptr->name);
 			} else {
 				node_ptr->extra_data = data;
+				node_extra_epoch++;
 			}
 		}
 
@@ -2937,9 +2948,11 @@ static void _split_node_config(node_record_t *node_ptr,
 		new_config_ptr->nodes = xstrdup(node_ptr->name);
 		node_ptr->config_ptr = new_config_ptr;
 		config_ptr = new_config_ptr;
+		part_config_epoch++;
 	}
 	config_ptr->cores = reg_msg->cores;
 	config_ptr->tot_sockets = reg_msg->sockets;
+	last_node_update = time(NULL);
 }
 
 /*
@@ -3263,7 +3276,15 @@ extern int validate_node_specs(slurm_msg_t *slurm_msg, bool *newly_up)
 						      now);
 	}
 
-	if (reg_msg->extra) {
+	/*
+	 * Nodes send their extra string with every registration; only decode
+	 * it again when it changed or has not been decoded yet.
+	 */
+	if (reg_msg->extra &&
+	    (xstrcmp(reg_msg->extra[0] ? reg_msg->extra : NULL,
+		     node_ptr->extra) ||
+	     (reg_msg->extra[0] && !node_ptr->extra_data &&
+	      extra_constraints_enabled()))) {
 		data_t *data = NULL;
 
 		if (extra_constraints_enabled() && reg_msg->extra[0] &&
@@ -3275,6 +3296,7 @@ extern int validate_node_specs(slurm_msg_t *slurm_msg, bool *newly_up)
 		}
 		FREE_NULL_DATA(node_ptr->extra_data);
 		node_ptr->extra_data = data;
+		node_extra_epoch++;
 
 		/*
 		 * Always set the extra field from the registration message,
@@ -5299,6 +5321,8 @@ static int _delete_node_ptr(node_record_t *node_ptr)
 	_remove_node_from_all_bitmaps(node_ptr);
 	_remove_node_from_features(node_ptr);
 	gres_node_remove(node_ptr);
+	node_extra_epoch++;
+	part_config_epoch++;
 
 	xhash_pop_str(node_hash_table, node_ptr->name);
 	slurm_conf_remove_node(node_ptr->name);
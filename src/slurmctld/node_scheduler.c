@@ -117,6 +117,22 @@ enum {
 	NM_TYPES	/* Number of node types */
 };
 
+/*
+ * Nodes of each node configuration which are in a given partition, in
+ * config_list order. These only change with the node or partition
+ * configuration, so they are shared by every job tested against the
+ * partition instead of being rebuilt by each _build_node_list() call.
+ */
+typedef struct {
+	int config_cnt;
+	config_record_t **config_ptr;
+	bitstr_t **node_bitmap;		/* config and partition nodes */
+	part_record_t *part_ptr;
+} part_config_cache_t;
+
+static list_t *part_config_cache_list = NULL;
+static uint64_t part_config_cache_epoch = 0;
+
 static int  _build_node_list(job_record_t *job_ptr,
 			     struct node_set **node_set_pptr,
 			     int *node_set_size, char **err_msg,
@@ -146,6 +162,78 @@ static bitstr_t *_valid_features(job_record_t *job_ptr,
 				 config_record_t *config_ptr,
 				 bool can_reboot, bitstr_t *reboot_bitmap);
 
+static void _part_config_cache_free(void *x)
+{
+	part_config_cache_t *cache = x;
+
+	for (int i = 0; i < cache->config_cnt; i++)
+		FREE_NULL_BITMAP(cache->node_bitmap[i]);
+	xfree(cache->node_bitmap);
+	xfree(cache->config_ptr);
+	xfree(cache);
+}
+
+static int _find_part_config_cache(void *x, void *key)
+{
+	part_config_cache_t *cache = x;
+
+	return (cache->part_ptr == key);
+}
+
+extern void node_scheduler_fini(void)
+{
+	FREE_NULL_LIST(part_config_cache_list);
+}
+
+/*
+ * Return the cached per configuration node bitmaps of a partition. The whole
+ * cache is dropped once part_config_epoch moved since it was built, that is
+ * once config_list, a node configuration's node_bitmap or a partition's
+ * node_bitmap changed. Node state changes and allocations leave it alone.
+ * Callers hold the job write lock, which serializes access to the cache.
+ */
+static part_config_cache_t *_get_part_config_cache(part_record_t *part_ptr)
+{
+	part_config_cache_t *cache;
+	config_record_t *config_ptr;
+	list_itr_t *config_iterator;
+	bitstr_t *tmp_bitmap;
+
+	if (!part_config_cache_list)
+		part_config_cache_list = list_create(_part_config_cache_free);
+
+	if (part_config_cache_epoch != part_config_epoch) {
+		list_flush(part_config_cache_list);
+		part_config_cache_epoch = part_config_epoch;
+	} else if ((cache = list_find_first(part_config_cache_list,
+					    _find_part_config_cache,
+					    part_ptr))) {
+		return cache;
+	}
+
+	cache = xmalloc(sizeof(*cache));
+	cache->part_ptr = part_ptr;
+	list_append(part_config_cache_list, cache);
+	cache->config_ptr = xcalloc(list_count(config_list),
+				    sizeof(config_record_t *));
+	cache->node_bitmap = xcalloc(list_count(config_list),
+				     sizeof(bitstr_t *));
+	config_iterator = list_iterator_create(config_list);
+	while ((config_ptr = list_next(config_iterator))) {
+		if (!bit_overlap_any(config_ptr->node_bitmap,
+				     part_ptr->node_bitmap))
+			continue;
+		tmp_bitmap = bit_copy(config_ptr->node_bitmap);
+		bit_and(tmp_bitmap, part_ptr->node_bitmap);
+		cache->config_ptr[cache->config_cnt] = config_ptr;
+		cache->node_bitmap[cache->config_cnt] = tmp_bitmap;
+		cache->config_cnt++;
+	}
+	list_iterator_destroy(config_iterator);
+
+	return cache;
+}
+
 /*
  * _get_ntasks_per_core - Retrieve the value of ntasks_per_core from
  *	the given job_details record.  If it wasn't set, return INFINITE16.
@@ -524,17 +612,30 @@ static void _log_feature_nodes(job_feature_t  *job_feat_ptr)
  * For every element in the feature_list, identify the nodes with that feature
  * either active or available and set the feature_list's node_bitmap_active and
  * node_bitmap_avail fields accordingly.
+ *
+ * The result is kept with each element along with the feature_list_epoch it
+ * was resolved against, so pending jobs evaluated on every scheduling pass
+ * only repeat the feature lookups after a node's features actually change.
  */
 extern void find_feature_nodes(List feature_list, bool can_reboot)
 {
 	list_itr_t *feat_iter;
 	job_feature_t  *job_feat_ptr;
 	node_feature_t *node_feat_ptr;
+	bool use_avail;
 
 	if (!feature_list)
 		return;
 	feat_iter = list_iterator_create(feature_list);
 	while ((job_feat_ptr = list_next(feat_iter))) {
+		use_avail = can_reboot && job_feat_ptr->changeable;
+		if ((job_feat_ptr->feature_epoch == feature_list_epoch) &&
+		    (job_feat_ptr->feature_reboot == use_avail) &&
+		    job_feat_ptr->node_bitmap_active &&
+		    job_feat_ptr->node_bitmap_avail)
+			continue;
+		job_feat_ptr->feature_epoch = feature_list_epoch;
+		job_feat_ptr->feature_reboot = use_avail;
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_active);
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_avail);
 		node_feat_ptr = list_find_first(active_feature_list,
@@ -547,7 +648,7 @@ extern void find_feature_nodes(List feature_list, bool can_reboot)
 			job_feat_ptr->node_bitmap_active =
 				bit_alloc(node_record_count);
 		}
-		if (can_reboot && job_feat_ptr->changeable) {
+		if (use_avail) {
 			node_feat_ptr = list_find_first(avail_feature_list,
 							list_find_feature,
 							job_feat_ptr->name);
@@ -3453,19 +3554,36 @@ static void _apply_extra_constraints(job_record_t *job_ptr,
 	xassert(job_ptr->extra);
 	xassert(job_ptr->extra_constraints);
 
+	/*
+	 * Results are kept per job until some node's extra data changes, so
+	 * each node is only tested once no matter how many partitions or
+	 * scheduling passes consider this job.
+	 */
+	if (!job_ptr->extra_tested_bitmap ||
+	    (job_ptr->extra_epoch != node_extra_epoch) ||
+	    (bit_size(job_ptr->extra_tested_bitmap) != node_record_count)) {
+		FREE_NULL_BITMAP(job_ptr->extra_tested_bitmap);
+		FREE_NULL_BITMAP(job_ptr->extra_pass_bitmap);
+		job_ptr->extra_tested_bitmap = bit_alloc(node_record_count);
+		job_ptr->extra_pass_bitmap = bit_alloc(node_record_count);
+		job_ptr->extra_epoch = node_extra_epoch;
+	}
+
 	for (int i = 0; (node_ptr = next_node_bitmap(usable_node_mask, &i));
 	     i++) {
-		if (!node_ptr->extra_data) {
-			bit_clear(usable_node_mask, i);
+		if (bit_test(job_ptr->extra_tested_bitmap, i))
 			continue;
-		}
+		bit_set(job_ptr->extra_tested_bitmap, i);
 
-		if (!extra_constraints_test(job_ptr->extra_constraints,
-					    node_ptr->extra_data)) {
-			bit_clear(usable_node_mask, i);
+		if (!node_ptr->extra_data)
 			continue;
-		}
+
+		if (extra_constraints_test(job_ptr->extra_constraints,
+					   node_ptr->extra_data))
+			bit_set(job_ptr->extra_pass_bitmap, i);
 	}
+
+	bit_and(usable_node_mask, job_ptr->extra_pass_bitmap);
 }
 
 /*
@@ -3492,7 +3610,7 @@ static int _build_node_list(job_record_t *job_ptr,
 	struct node_set *node_set_ptr, *prev_node_set_ptr;
 	config_record_t *config_ptr;
 	part_record_t *part_ptr = job_ptr->part_ptr;
-	list_itr_t *config_iterator;
+	part_config_cache_t *part_cache;
 	int total_cores;
 	job_details_t *detail_ptr = job_ptr->details;
 	bitstr_t *usable_node_mask = NULL;
@@ -3599,10 +3717,11 @@ static int _build_node_list(job_record_t *job_ptr,
 	node_set_inx = 0;
 	node_set_len = list_count(config_list) * 16 + 1;
 	node_set_ptr = xcalloc(node_set_len, sizeof(struct node_set));
-	config_iterator = list_iterator_create(config_list);
-	while ((config_ptr = list_next(config_iterator))) {
+	part_cache = _get_part_config_cache(part_ptr);
+	for (int c = 0; c < part_cache->config_cnt; c++) {
 		bool cpus_ok = false, mem_ok = false, disk_ok = false;
 		bool job_mc_ok = false, config_filter = false;
+		config_ptr = part_cache->config_ptr[c];
 		total_cores = config_ptr->tot_sockets * config_ptr->cores;
 		adj_cpus = adjust_cpus_nppcu(_get_ntasks_per_core(detail_ptr),
 					     detail_ptr->cpus_per_task,
@@ -3631,9 +3750,7 @@ static int _build_node_list(job_record_t *job_ptr,
 		 * for scheduling, but only as needed (slower)
 		 */
 		node_set_ptr[node_set_inx].my_bitmap =
-			bit_copy(config_ptr->node_bitmap);
-		bit_and(node_set_ptr[node_set_inx].my_bitmap,
-			part_ptr->node_bitmap);
+			bit_copy(part_cache->node_bitmap[c]);
 		if (usable_node_mask) {
 			bit_and(node_set_ptr[node_set_inx].my_bitmap,
 				usable_node_mask);
@@ -3860,7 +3977,6 @@ end_node_set:
 			break;
 		}
 	}
-	list_iterator_destroy(config_iterator);
 
 	/* eliminate any incomplete node_set record */
 	xfree(node_set_ptr[node_set_inx].features);
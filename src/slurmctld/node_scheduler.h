@@ -107,6 +107,9 @@ extern void filter_by_node_owner(job_record_t *job_ptr,
  */
 extern void find_feature_nodes(List feature_list, bool can_reboot);
 
+/* Free the partition node configuration cache used by select_nodes() */
+extern void node_scheduler_fini(void);
+
 /*
  * re_kill_job - for a given job, deallocate its nodes for a second time,
  *	basically a cleanup for failed deallocate() calls
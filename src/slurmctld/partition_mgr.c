@@ -207,6 +207,7 @@ extern int build_part_bitmap(part_record_t *part_ptr)
 	part_ptr->total_nodes = 0;
 	part_ptr->max_cpu_cnt = 0;
 	part_ptr->max_core_cnt = 0;
+	part_config_epoch++;
 
 	if (part_ptr->node_bitmap == NULL) {
 		part_ptr->node_bitmap = bit_alloc(node_record_count);
@@ -952,6 +953,7 @@ static void _list_delete_part(void *part_entry)
 	xfree(part_ptr->nodes);
 	xfree(part_ptr->nodesets);
 	FREE_NULL_BITMAP(part_ptr->node_bitmap);
+	part_config_epoch++;
 	xfree(part_ptr->qos_char);
 	xfree(part_ptr->tres_cnt);
 	xfree(part_ptr->tres_fmt_str);
@@ -1872,6 +1874,7 @@ extern int update_part(update_part_msg_t * part_desc, bool create_flag)
 	} else if (part_ptr->node_bitmap == NULL) {
 		/* Newly created partition needs a bitmap, even if empty */
 		part_ptr->node_bitmap = bit_alloc(node_record_count);
+		part_config_epoch++;
 	}
 
 fini:
@@ -43,17 +43,16 @@
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/srun_comm.h"
 
-extern void prep_prolog_slurmctld_callback(int rc, uint32_t job_id,
-					   bool timed_out)
+/*
+ * Caller must hold job and node write locks and fed read lock.
+ */
+extern void prep_prolog_slurmctld_callback_locked(int rc, uint32_t job_id,
+						  bool timed_out)
 {
-	slurmctld_lock_t job_write_lock =
-		{ .job = WRITE_LOCK, .node = WRITE_LOCK, .fed = READ_LOCK };
 	job_record_t *job_ptr;
 
-	lock_slurmctld(job_write_lock);
 	if (!(job_ptr = find_job_record(job_id))) {
 		error("%s: missing JobId=%u", __func__, job_id);
-		unlock_slurmctld(job_write_lock);
 		return;
 	}
 	if (WIFSIGNALED(rc) && timed_out) {
@@ -80,7 +79,6 @@ extern void prep_prolog_slurmctld_callback(int rc, uint32_t job_id,
 	if (job_ptr->prep_prolog_cnt) {
 		debug2("%s: still %u async prologs left to complete",
 		       __func__, job_ptr->prep_prolog_cnt);
-		unlock_slurmctld(job_write_lock);
 		return;
 	}
 
@@ -130,21 +128,29 @@ extern void prep_prolog_slurmctld_callback(int rc, uint32_t job_id,
 		debug2("prolog_slurmctld JobId=%u prolog completed", job_id);
 
 	prolog_running_decr(job_ptr);
+}
 
+extern void prep_prolog_slurmctld_callback(int rc, uint32_t job_id,
+					   bool timed_out)
+{
+	slurmctld_lock_t job_write_lock =
+		{ .job = WRITE_LOCK, .node = WRITE_LOCK, .fed = READ_LOCK };
+
+	lock_slurmctld(job_write_lock);
+	prep_prolog_slurmctld_callback_locked(rc, job_id, timed_out);
 	unlock_slurmctld(job_write_lock);
 }
 
-extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
-					   bool timed_out)
+/*
+ * Caller must hold job and node write locks.
+ */
+extern void prep_epilog_slurmctld_callback_locked(int rc, uint32_t job_id,
+						  bool timed_out)
 {
-	slurmctld_lock_t job_write_lock = {
-		.job = WRITE_LOCK, .node = WRITE_LOCK};
 	job_record_t *job_ptr;
 
-	lock_slurmctld(job_write_lock);
 	if (!(job_ptr = find_job_record(job_id))) {
 		error("%s: missing JobId=%u", __func__, job_id);
-		unlock_slurmctld(job_write_lock);
 		return;
 	}
 	if (timed_out) {
@@ -159,7 +165,6 @@ extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
 	if (job_ptr->prep_epilog_cnt) {
 		debug2("%s: still %u async epilogs left to complete",
 		       __func__, job_ptr->prep_epilog_cnt);
-		unlock_slurmctld(job_write_lock);
 		return;
 	}
 
@@ -174,6 +179,15 @@ extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
 		cleanup_completing(job_ptr);
 		batch_requeue_fini(job_ptr);
 	}
+}
 
+extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
+					   bool timed_out)
+{
+	slurmctld_lock_t job_write_lock = {
+		.job = WRITE_LOCK, .node = WRITE_LOCK};
+
+	lock_slurmctld(job_write_lock);
+	prep_epilog_slurmctld_callback_locked(rc, job_id, timed_out);
 	unlock_slurmctld(job_write_lock);
 }
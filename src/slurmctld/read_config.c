@@ -97,6 +97,7 @@
 /* Global variables */
 List active_feature_list;	/* list of currently active features_records */
 List avail_feature_list;	/* list of available features_records */
+uint32_t feature_list_epoch = 1;	/* bumped when either list changes */
 bool node_features_updated = true;
 bool slurmctld_init_db = true;
 
@@ -410,6 +411,7 @@ static void _build_node_config_bitmaps(void)
 
 	/* initialize the configuration bitmaps */
 	list_for_each(config_list, _reset_node_bitmaps, NULL);
+	part_config_epoch++;
 
 	for (int i = 0; (node_ptr = next_node(&i)); i++) {
 		if (node_ptr->config_ptr)
@@ -1908,6 +1910,7 @@ extern void build_feature_list_eq(void)
 	FREE_NULL_LIST(avail_feature_list);
 	active_feature_list = list_create(_list_delete_feature);
 	avail_feature_list = list_create(_list_delete_feature);
+	feature_list_epoch++;
 
 	config_iterator = list_iterator_create(config_list);
 	while ((config_ptr = list_next(config_iterator))) {
@@ -1977,6 +1980,7 @@ extern void build_feature_list_ne(void)
 	FREE_NULL_LIST(avail_feature_list);
 	active_feature_list = list_create(_list_delete_feature);
 	avail_feature_list = list_create(_list_delete_feature);
+	feature_list_epoch++;
 
 	for (i = 0; (node_ptr = next_node(&i)); i++) {
 		if (node_ptr->features_act) {
@@ -2034,6 +2038,7 @@ extern void update_feature_list(List feature_list, char *new_features,
 		}
 		xfree(tmp_str);
 	}
+	feature_list_epoch++;
 	node_features_updated = true;
 }
 
@@ -218,6 +218,13 @@ typedef struct diag_stats {
 	time_t   bf_when_last_cycle;
 
 	uint32_t latency;
+
+	uint32_t prep_script_cnt;
+	uint32_t prep_script_inflight;
+	uint32_t prep_script_queue_max;
+	uint64_t prep_script_queue_sum;
+	uint32_t prep_script_run_max;
+	uint64_t prep_script_run_sum;
 } diag_stats_t;
 
 typedef struct {
@@ -285,6 +292,7 @@ typedef struct node_features {
 
 extern List active_feature_list;/* list of currently active node features */
 extern List avail_feature_list;	/* list of available node features */
+extern uint32_t feature_list_epoch; /* changes whenever either list changes */
 extern List conf_includes_list; /* list of conf_includes_map_t */
 
 #define PACK_FANOUT_ADDRS(_X) \
@@ -322,6 +330,11 @@ extern bitstr_t *power_node_bitmap;	/* Powered down nodes */
 extern bitstr_t *share_node_bitmap;	/* bitmap of sharable nodes */
 extern bitstr_t *up_node_bitmap;	/* bitmap of up nodes, not DOWN */
 extern bitstr_t *rs_node_bitmap;	/* next_state=resume nodes */
+extern uint32_t node_extra_epoch;	/* bumped when any node's extra_data
+					 * changes */
+extern uint32_t part_config_epoch;	/* bumped when config_list, a
+					 * config_record's node_bitmap or a
+					 * partition's node_bitmap changes */
 
 /*****************************************************************************\
  *  FRONT_END parameters and data structures
@@ -786,6 +799,11 @@ struct job_record {
 	elem_t *extra_constraints;	/* Head of tree built from constraints
 					 * defined in "extra". Not state saved.
 					 */
+	bitstr_t *extra_pass_bitmap;	/* nodes satisfying extra_constraints,
+					 * valid for extra_tested_bitmap */
+	bitstr_t *extra_tested_bitmap;	/* nodes already tested against
+					 * extra_constraints */
+	uint32_t extra_epoch;		/* node_extra_epoch of the above */
 	char *failed_node;		/* Name of node that failed which caused
 					 * this job to be killed.
 					 * NULL in all other situations */
@@ -3005,6 +3023,16 @@ extern void prep_prolog_slurmctld_callback(int rc, uint32_t job_id,
 extern void prep_epilog_slurmctld_callback(int rc, uint32_t job_id,
 					   bool timed_out);
 
+/*
+ * Same as above, but the caller already holds the job and node write locks
+ * (and the fed read lock for the prolog variant). Used to deliver a batch of
+ * completions under a single lock acquisition.
+ */
+extern void prep_prolog_slurmctld_callback_locked(int rc, uint32_t job_id,
+						  bool timed_out);
+extern void prep_epilog_slurmctld_callback_locked(int rc, uint32_t job_id,
+						  bool timed_out);
+
 /*
  * Set node's comm_name and hostname.
  *
@@ -57,6 +57,7 @@
 #include "src/common/run_command.h"
 #include "src/common/setproctitle.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/timers.h"
 #include "src/common/track_script.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -115,6 +116,7 @@ typedef struct {
 } script_response_t;
 
 static void _incr_script_cnt(void);
+static void _prep_script_release_waiters(void);
 
 static bool shutting_down = false;
 static int slurmctld_readfd = -1;
@@ -128,6 +130,26 @@ static pthread_cond_t script_count_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t script_resp_map_mutex = PTHREAD_MUTEX_INITIALIZER;
 static xhash_t *script_resp_map = NULL;
 
+/*
+ * PrologSlurmctld/EpilogSlurmctld completions are handed to a single thread
+ * which delivers everything queued so far under one job write lock instead
+ * of having every completion contend for the lock on its own.
+ */
+typedef struct {
+	uint32_t job_id;
+	uint32_t queue_usec;
+	uint32_t run_usec;
+	script_type_t script_type;
+	int status;
+	bool timed_out;
+} prep_complete_t;
+
+static list_t *prep_complete_list = NULL;
+static pthread_mutex_t prep_complete_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prep_complete_cond = PTHREAD_COND_INITIALIZER;
+static bool prep_complete_shutdown = false;
+static pthread_t prep_complete_tid;
+
 /*
  *****************************************************************************
  * The following are meant to be used by only slurmscriptd
@@ -140,6 +162,16 @@ static pthread_cond_t powersave_script_cond = PTHREAD_COND_INITIALIZER;
 static int powersave_script_count = 0;
 static bool powersave_wait_called = false;
 
+/*
+ * Limit on concurrently running PrologSlurmctld/EpilogSlurmctld scripts,
+ * set with SlurmctldParameters=max_prep_script_cnt. 0 means unlimited.
+ */
+static pthread_mutex_t prep_script_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prep_script_cond = PTHREAD_COND_INITIALIZER;
+static int prep_script_max_cnt = 0;
+static int prep_script_run_cnt = 0;
+static bool prep_script_shutdown = false;
+
 
 /* Function definitions: */
 
@@ -302,6 +334,7 @@ static int _handle_close(eio_obj_t *obj, List objs)
 	obj->shutdown = true;
 
 	if (!running_in_slurmctld()) { /* Only do this for slurmscriptd */
+		_prep_script_release_waiters();
 		_wait_for_powersave_scripts();
 		track_script_flush();
 	} else {
@@ -399,9 +432,21 @@ cleanup:
 static void *_async_send_to_slurmscriptd(void *x)
 {
 	slurmscriptd_msg_t *send_args = x;
-
-	_send_to_slurmscriptd(send_args->msg_type, send_args->msg_data, false,
-			      NULL, NULL);
+	run_script_msg_t *run_script_msg = send_args->msg_data;
+
+	if ((_send_to_slurmscriptd(send_args->msg_type, send_args->msg_data,
+				   false, NULL, NULL) != SLURM_SUCCESS) &&
+	    (send_args->msg_type == SLURMSCRIPTD_REQUEST_RUN_SCRIPT) &&
+	    ((run_script_msg->script_type == SLURMSCRIPTD_PROLOG) ||
+	     (run_script_msg->script_type == SLURMSCRIPTD_EPILOG))) {
+		/* No completion will arrive for this script */
+		slurmctld_lock_t job_write_lock = { .job = WRITE_LOCK };
+
+		lock_slurmctld(job_write_lock);
+		if (slurmctld_diag_stats.prep_script_inflight)
+			slurmctld_diag_stats.prep_script_inflight--;
+		unlock_slurmctld(job_write_lock);
+	}
 	slurmscriptd_free_msg(send_args);
 	xfree(send_args);
 
@@ -413,7 +458,8 @@ static void *_async_send_to_slurmscriptd(void *x)
  */
 static int _respond_to_slurmctld(char *key, uint32_t job_id, char *resp_msg,
 				 char *script_name, script_type_t script_type,
-				 bool signalled, int status, bool timed_out)
+				 bool signalled, int status, bool timed_out,
+				 uint32_t queue_usec, uint32_t run_usec)
 {
 	int rc = SLURM_SUCCESS;
 	slurmscriptd_msg_t msg;
@@ -432,6 +478,8 @@ static int _respond_to_slurmctld(char *key, uint32_t job_id, char *resp_msg,
 	script_complete.signalled = signalled;
 	script_complete.status = status;
 	script_complete.timed_out = timed_out;
+	script_complete.queue_usec = queue_usec;
+	script_complete.run_usec = run_usec;
 
 	memset(&msg, 0, sizeof(msg));
 	msg.key = key;
@@ -555,6 +603,41 @@ static int _run_script(run_command_args_t *run_command_args, uint32_t job_id,
 	return status;
 }
 
+/*
+ * Wait for a PrologSlurmctld/EpilogSlurmctld slot.
+ * Return false if slurmscriptd is shutting down and the script must not run.
+ */
+static bool _prep_script_slot_get(void)
+{
+	bool rc;
+
+	slurm_mutex_lock(&prep_script_mutex);
+	while (prep_script_max_cnt && !prep_script_shutdown &&
+	       (prep_script_run_cnt >= prep_script_max_cnt))
+		slurm_cond_wait(&prep_script_cond, &prep_script_mutex);
+	if ((rc = !prep_script_shutdown))
+		prep_script_run_cnt++;
+	slurm_mutex_unlock(&prep_script_mutex);
+
+	return rc;
+}
+
+static void _prep_script_slot_put(void)
+{
+	slurm_mutex_lock(&prep_script_mutex);
+	prep_script_run_cnt--;
+	slurm_cond_signal(&prep_script_cond);
+	slurm_mutex_unlock(&prep_script_mutex);
+}
+
+static void _prep_script_release_waiters(void)
+{
+	slurm_mutex_lock(&prep_script_mutex);
+	prep_script_shutdown = true;
+	slurm_cond_broadcast(&prep_script_cond);
+	slurm_mutex_unlock(&prep_script_mutex);
+}
+
 static int _handle_flush(slurmscriptd_msg_t *recv_msg)
 {
 	log_flag(SCRIPT, "Handling %s", rpc_num2string(recv_msg->msg_type));
@@ -569,7 +652,7 @@ static int _handle_flush(slurmscriptd_msg_t *recv_msg)
 	/* We need to respond to slurmctld that we are done */
 	_respond_to_slurmctld(recv_msg->key, 0, NULL,
 			      "SLURMSCRIPTD_REQUEST_FLUSH", SLURMSCRIPTD_NONE,
-			      false, SLURM_SUCCESS, false);
+			      false, SLURM_SUCCESS, false, 0, 0);
 
 	return SLURM_SUCCESS;
 }
@@ -705,6 +788,7 @@ static int _handle_shutdown(slurmscriptd_msg_t *recv_msg)
 {
 	log_flag(SCRIPT, "Handling %s", rpc_num2string(recv_msg->msg_type));
 	/* Kill or orphan all running scripts. */
+	_prep_script_release_waiters();
 	_wait_for_powersave_scripts();
 	track_script_flush();
 
@@ -720,6 +804,8 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 	char *resp_msg = NULL;
 	bool signalled = false;
 	bool timed_out = false;
+	uint32_t queue_usec = 0, run_usec = 0;
+	struct timeval tv;
 	pthread_t tid = pthread_self();
 	run_command_args_t run_command_args = {
 		.env = env_array_copy((const char **) script_msg->env),
@@ -747,8 +833,32 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 					&signalled);
 		break;
 	case SLURMSCRIPTD_EPILOG: /* fall-through */
-	case SLURMSCRIPTD_MAIL:
 	case SLURMSCRIPTD_PROLOG:
+		gettimeofday(&tv, NULL);
+		if (!_prep_script_slot_get()) {
+			/*
+			 * Shutting down before the script got to run. Report
+			 * it the same way as a script killed by
+			 * track_script_flush().
+			 */
+			log_flag(SCRIPT, "%s: JobId=%u %s not run, shutting down",
+				 __func__, script_msg->job_id,
+				 script_msg->script_name);
+			status = SIGKILL;
+			signalled = true;
+			break;
+		}
+		queue_usec = slurm_delta_tv(&tv);
+		gettimeofday(&tv, NULL);
+		status = _run_script(&run_command_args, script_msg->job_id,
+				     script_msg->timeout,
+				     script_msg->tmp_file_env_name,
+				     script_msg->tmp_file_str,
+				     &resp_msg, &signalled);
+		run_usec = slurm_delta_tv(&tv);
+		_prep_script_slot_put();
+		break;
+	case SLURMSCRIPTD_MAIL:
 	case SLURMSCRIPTD_REBOOT:
 	case SLURMSCRIPTD_RESV:
 		/*
@@ -793,7 +903,7 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 	rc = _respond_to_slurmctld(recv_msg->key, script_msg->job_id,
 				   resp_msg, script_msg->script_name,
 				   script_msg->script_type, signalled, status,
-				   timed_out);
+				   timed_out, queue_usec, run_usec);
 
 	if (script_msg->script_type == SLURMSCRIPTD_POWER) {
 		slurm_mutex_lock(&powersave_script_count_mutex);
@@ -838,6 +948,90 @@ static int _notify_script_done(char *key, script_complete_t *script_complete)
 	return rc;
 }
 
+static int _deliver_prep_complete(void *x, void *arg)
+{
+	prep_complete_t *prep_complete = x;
+
+	if (prep_complete->script_type == SLURMSCRIPTD_PROLOG)
+		prep_prolog_slurmctld_callback_locked(prep_complete->status,
+						      prep_complete->job_id,
+						      prep_complete->timed_out);
+	else
+		prep_epilog_slurmctld_callback_locked(prep_complete->status,
+						      prep_complete->job_id,
+						      prep_complete->timed_out);
+
+	if (slurmctld_diag_stats.prep_script_inflight)
+		slurmctld_diag_stats.prep_script_inflight--;
+	slurmctld_diag_stats.prep_script_cnt++;
+	slurmctld_diag_stats.prep_script_queue_sum += prep_complete->queue_usec;
+	slurmctld_diag_stats.prep_script_queue_max =
+		MAX(slurmctld_diag_stats.prep_script_queue_max,
+		    prep_complete->queue_usec);
+	slurmctld_diag_stats.prep_script_run_sum += prep_complete->run_usec;
+	slurmctld_diag_stats.prep_script_run_max =
+		MAX(slurmctld_diag_stats.prep_script_run_max,
+		    prep_complete->run_usec);
+
+	return 0;
+}
+
+static void *_prep_complete_thread(void *x)
+{
+	slurmctld_lock_t job_write_lock =
+		{ .job = WRITE_LOCK, .node = WRITE_LOCK, .fed = READ_LOCK };
+	list_t *batch;
+	int cnt;
+
+	slurm_mutex_lock(&prep_complete_mutex);
+	while (true) {
+		while (!list_count(prep_complete_list) &&
+		       !prep_complete_shutdown)
+			slurm_cond_wait(&prep_complete_cond,
+					&prep_complete_mutex);
+		if (!list_count(prep_complete_list))
+			break;
+
+		batch = prep_complete_list;
+		prep_complete_list = list_create(xfree_ptr);
+		slurm_mutex_unlock(&prep_complete_mutex);
+
+		cnt = list_count(batch);
+		log_flag(SCRIPT, "%s: delivering %d PrologSlurmctld/EpilogSlurmctld completions",
+			 __func__, cnt);
+
+		lock_slurmctld(job_write_lock);
+		(void) list_for_each(batch, _deliver_prep_complete, NULL);
+		unlock_slurmctld(job_write_lock);
+		FREE_NULL_LIST(batch);
+
+		for (int i = 0; i < cnt; i++)
+			_decr_script_cnt();
+
+		slurm_mutex_lock(&prep_complete_mutex);
+	}
+	slurm_mutex_unlock(&prep_complete_mutex);
+
+	return NULL;
+}
+
+static void _queue_prep_complete(script_complete_t *script_complete)
+{
+	prep_complete_t *prep_complete = xmalloc(sizeof(*prep_complete));
+
+	prep_complete->job_id = script_complete->job_id;
+	prep_complete->queue_usec = script_complete->queue_usec;
+	prep_complete->run_usec = script_complete->run_usec;
+	prep_complete->script_type = script_complete->script_type;
+	prep_complete->status = script_complete->status;
+	prep_complete->timed_out = script_complete->timed_out;
+
+	slurm_mutex_lock(&prep_complete_mutex);
+	list_append(prep_complete_list, prep_complete);
+	slurm_cond_signal(&prep_complete_cond);
+	slurm_mutex_unlock(&prep_complete_mutex);
+}
+
 static int _handle_script_complete(slurmscriptd_msg_t *msg)
 {
 	int rc = SLURM_SUCCESS;
@@ -859,19 +1053,14 @@ static int _handle_script_complete(slurmscriptd_msg_t *msg)
 	case SLURMSCRIPTD_REBOOT:
 	case SLURMSCRIPTD_RESV:
 		break; /* Nothing more to do */
-	case SLURMSCRIPTD_EPILOG:
-		prep_epilog_slurmctld_callback(script_complete->status,
-					       script_complete->job_id,
-					       script_complete->timed_out);
-		break;
+	case SLURMSCRIPTD_EPILOG: /* fall-through */
+	case SLURMSCRIPTD_PROLOG:
+		/* _prep_complete_thread() calls _decr_script_cnt() */
+		_queue_prep_complete(script_complete);
+		return rc;
 	case SLURMSCRIPTD_POWER:
 		ping_nodes_now = true;
 		break;
-	case SLURMSCRIPTD_PROLOG:
-		prep_prolog_slurmctld_callback(script_complete->status,
-					       script_complete->job_id,
-					       script_complete->timed_out);
-		break;
 	case SLURMSCRIPTD_NONE:
 		/*
 		 * Some other RPC (for example, SLURMSCRIPTD_REQUEST_FLUSH)
@@ -1305,6 +1494,8 @@ extern void slurmscriptd_run_prepilog(uint32_t job_id, bool is_epilog,
 	run_script_msg->argv[0] = xstrdup(script);
 	run_script_msg->job_id = job_id;
 
+	slurmctld_diag_stats.prep_script_inflight++;
+
 	/*
 	 * Because this thread is holding the job write lock, do the write in
 	 * a different detached thread so we do not lock up the slurmctld
@@ -1455,6 +1646,9 @@ extern int slurmscriptd_init(int argc, char **argv)
 		slurm_mutex_init(&write_mutex);
 		slurm_mutex_init(&script_resp_map_mutex);
 		script_resp_map = xhash_init(_resp_map_key_id, _resp_map_free);
+		prep_complete_list = list_create(xfree_ptr);
+		slurm_thread_create(&prep_complete_tid, _prep_complete_thread,
+				    NULL);
 		_setup_eio(slurmctld_readfd);
 		slurm_thread_create(&slurmctld_listener_tid,
 				    _slurmctld_listener_thread, NULL);
@@ -1465,6 +1659,7 @@ extern int slurmscriptd_init(int argc, char **argv)
 		char *proc_name = "slurmscriptd";
 		char *log_prefix;
 		char *failed_plugin = NULL;
+		char *tmp_ptr;
 
 		/*
 		 * Since running_in_slurmctld() is called before we fork()'d,
@@ -1549,6 +1744,27 @@ extern int slurmscriptd_init(int argc, char **argv)
 
 		slurm_mutex_init(&powersave_script_count_mutex);
 		slurm_mutex_init(&write_mutex);
+		if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+					   "max_prep_script_cnt="))) {
+			char *end_ptr = NULL;
+			long max_cnt = strtol(tmp_ptr + 20, &end_ptr, 10);
+
+			if ((end_ptr == (tmp_ptr + 20)) ||
+			    (*end_ptr && (*end_ptr != ','))) {
+				error("Invalid SlurmctldParameters max_prep_script_cnt, running PrologSlurmctld/EpilogSlurmctld scripts without a limit");
+			} else {
+				if ((max_cnt < 0) || (max_cnt >= NO_VAL16)) {
+					max_cnt = MAX(MIN(max_cnt,
+							  NO_VAL16 - 1), 0);
+					error("SlurmctldParameters max_prep_script_cnt out of range, using %ld",
+					      max_cnt);
+				}
+				prep_script_max_cnt = max_cnt;
+			}
+			if (prep_script_max_cnt)
+				debug("Running at most %d PrologSlurmctld/EpilogSlurmctld scripts at once",
+				      prep_script_max_cnt);
+		}
 		_slurmscriptd_mainloop();
 
 #ifdef MEMORY_LEAK_DEBUG
@@ -1571,6 +1787,12 @@ extern int slurmscriptd_fini(void)
 	/* Now shutdown communications. */
 	eio_signal_shutdown(msg_handle);
 	slurm_thread_join(slurmctld_listener_tid);
+	slurm_mutex_lock(&prep_complete_mutex);
+	prep_complete_shutdown = true;
+	slurm_cond_signal(&prep_complete_cond);
+	slurm_mutex_unlock(&prep_complete_mutex);
+	slurm_thread_join(prep_complete_tid);
+	FREE_NULL_LIST(prep_complete_list);
 	slurm_mutex_destroy(&script_resp_map_mutex);
 	xhash_clear(script_resp_map);
 	slurm_mutex_destroy(&write_mutex);
@@ -64,7 +64,9 @@ typedef struct {
 
 typedef struct {
 	uint32_t job_id;
+	uint32_t queue_usec; /* time waiting for a free script slot */
 	char *resp_msg;
+	uint32_t run_usec; /* time the script ran */
 	char *script_name;
 	script_type_t script_type;
 	bool signalled;
@@ -98,6 +98,8 @@ static void _pack_script_complete(script_complete_t *resp_msg, buf_t *buffer)
 	packbool(resp_msg->signalled, buffer);
 	pack32(resp_msg->status, buffer);
 	packbool(resp_msg->timed_out, buffer);
+	pack32(resp_msg->queue_usec, buffer);
+	pack32(resp_msg->run_usec, buffer);
 }
 
 static int _unpack_script_complete(script_complete_t **resp_msg,
@@ -115,6 +117,8 @@ static int _unpack_script_complete(script_complete_t **resp_msg,
 	safe_unpack32(&tmp32, buffer);
 	data->status = (int)tmp32;
 	safe_unpackbool(&data->timed_out, buffer);
+	safe_unpack32(&data->queue_usec, buffer);
+	safe_unpack32(&data->run_usec, buffer);
 
 	return SLURM_SUCCESS;
 
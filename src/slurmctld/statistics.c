@@ -122,6 +122,20 @@ extern buf_t *pack_all_stat(uint16_t protocol_version)
 		pack32(slurmctld_diag_stats.backfilled_het_jobs, buffer);
 		pack32_array(slurmctld_diag_stats.bf_exit, BF_EXIT_COUNT,
 			     buffer);
+
+		if (protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+			pack32(slurmctld_diag_stats.prep_script_inflight,
+			       buffer);
+			pack32(slurmctld_diag_stats.prep_script_cnt, buffer);
+			pack64(slurmctld_diag_stats.prep_script_queue_sum,
+			       buffer);
+			pack32(slurmctld_diag_stats.prep_script_queue_max,
+			       buffer);
+			pack64(slurmctld_diag_stats.prep_script_run_sum,
+			       buffer);
+			pack32(slurmctld_diag_stats.prep_script_run_max,
+			       buffer);
+		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack32(1, buffer);
 
@@ -225,5 +239,12 @@ extern void reset_stats(int level)
 	memset(slurmctld_diag_stats.bf_exit, 0,
 	       sizeof(slurmctld_diag_stats.bf_exit));
 
+	/* prep_script_inflight is a gauge, not reset */
+	slurmctld_diag_stats.prep_script_cnt = 0;
+	slurmctld_diag_stats.prep_script_queue_sum = 0;
+	slurmctld_diag_stats.prep_script_queue_max = 0;
+	slurmctld_diag_stats.prep_script_run_sum = 0;
+	slurmctld_diag_stats.prep_script_run_max = 0;
+
 	last_proc_req_start = time(NULL);
 }
@@ -1247,8 +1247,13 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 		node_record_t *node_ptr;
 		bitstr_t *trigger_idle_node_bitmap;
 
+		/* Only look at the nodes this trigger is interested in */
 		trigger_idle_node_bitmap = bit_alloc(node_record_count);
-		for (i = 0; (node_ptr = next_node(&i)); i++) {
+		for (i = 0;
+		     (node_ptr = trig_in->nodes_bitmap ?
+		      next_node_bitmap(trig_in->nodes_bitmap, &i) :
+		      next_node(&i));
+		     i++) {
 			if (!IS_NODE_IDLE(node_ptr) ||
 			    (node_ptr->last_busy > min_idle))
 				continue;
@@ -1595,6 +1600,69 @@ static void _clear_event_triggers(void)
 	trigger_pri_db_res_op = false;
 }
 
+/*
+ * Return the TRIGGER_TYPE_* events recorded since the last trigger_process()
+ * so triggers which can not fire on them are not evaluated at all.
+ */
+static uint32_t _pending_event_types(void)
+{
+	uint32_t event_types = 0;
+
+	if ((trigger_down_front_end_bitmap &&
+	     (bit_ffs(trigger_down_front_end_bitmap) != -1)) ||
+	    (trigger_down_nodes_bitmap &&
+	     (bit_ffs(trigger_down_nodes_bitmap) != -1)))
+		event_types |= TRIGGER_TYPE_DOWN;
+	if ((trigger_up_front_end_bitmap &&
+	     (bit_ffs(trigger_up_front_end_bitmap) != -1)) ||
+	    (trigger_up_nodes_bitmap &&
+	     (bit_ffs(trigger_up_nodes_bitmap) != -1)))
+		event_types |= TRIGGER_TYPE_UP;
+	if (trigger_drained_nodes_bitmap &&
+	    (bit_ffs(trigger_drained_nodes_bitmap) != -1))
+		event_types |= TRIGGER_TYPE_DRAINED;
+	if (trigger_fail_nodes_bitmap &&
+	    (bit_ffs(trigger_fail_nodes_bitmap) != -1))
+		event_types |= TRIGGER_TYPE_FAIL;
+	if (trigger_draining_nodes_bitmap &&
+	    (bit_ffs(trigger_draining_nodes_bitmap) != -1))
+		event_types |= TRIGGER_TYPE_DRAINING;
+	if (trigger_resume_nodes_bitmap &&
+	    (bit_ffs(trigger_resume_nodes_bitmap) != -1))
+		event_types |= TRIGGER_TYPE_RESUME;
+	if (trigger_node_reconfig)
+		event_types |= TRIGGER_TYPE_RECONFIG;
+	if (trigger_bb_error)
+		event_types |= TRIGGER_TYPE_BURST_BUFFER;
+
+	return event_types;
+}
+
+/*
+ * Return true if a pending trigger could be pulled by the recorded events.
+ * Job fini/time and node idle triggers depend on current state rather than
+ * on recorded events, so they are always evaluated. Job triggers whose job
+ * record is gone are also evaluated so that they get purged.
+ */
+static bool _trigger_may_fire(trig_mgr_info_t *trig_in, uint32_t event_types)
+{
+	switch (trig_in->res_type) {
+	case TRIGGER_RES_TYPE_JOB:
+		if (trig_in->trig_type &
+		    (event_types | TRIGGER_TYPE_FINI | TRIGGER_TYPE_TIME))
+			return true;
+		return !find_job_record(trig_in->job_id);
+	case TRIGGER_RES_TYPE_NODE:
+		return (trig_in->trig_type &
+			(event_types | TRIGGER_TYPE_IDLE));
+	case TRIGGER_RES_TYPE_FRONT_END:
+	case TRIGGER_RES_TYPE_OTHER:
+		return (trig_in->trig_type & event_types);
+	default:
+		return true;
+	}
+}
+
 /* Make a copy of a trigger and pre-pend it on our list */
 static void _trigger_clone(trig_mgr_info_t *trig_in)
 {
@@ -1630,14 +1698,17 @@ extern void trigger_process(void)
 	bool state_change = false;
 	pid_t rc;
 	int prog_stat;
+	uint32_t event_types;
 
 	slurm_mutex_lock(&trigger_mutex);
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 
+	event_types = _pending_event_types();
 	trig_iter = list_iterator_create(trigger_list);
 	while ((trig_in = list_next(trig_iter))) {
-		if (trig_in->state == 0) {
+		if ((trig_in->state == 0) &&
+		    _trigger_may_fire(trig_in, event_types)) {
 			if (trig_in->res_type == TRIGGER_RES_TYPE_OTHER)
 				_trigger_other_event(trig_in, now);
 			else if (trig_in->res_type == TRIGGER_RES_TYPE_JOB)
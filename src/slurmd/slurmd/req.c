@@ -95,6 +95,7 @@
 #include "src/common/spank.h"
 #include "src/common/stepd_api.h"
 #include "src/interfaces/switch.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/util-net.h"
 #include "src/common/xstring.h"
@@ -272,6 +273,18 @@ static active_job_t active_job_id[JOB_STATE_CNT] = {{0}};
 static pthread_mutex_t prolog_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t prolog_serial_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Prolog/Epilog slots, limited by SlurmdParameters=max_prep_script_cnt,
+ * and run time statistics reported by _rpc_daemon_status().
+ */
+static pthread_mutex_t prep_slot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prep_slot_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t prep_queued = 0;
+static uint32_t prep_running = 0;
+static uint32_t prep_wait_max = 0;
+static uint32_t prolog_hist[PREP_HIST_CNT] = { 0 };
+static uint32_t epilog_hist[PREP_HIST_CNT] = { 0 };
+
 #define FILE_BCAST_TIMEOUT 300
 static pthread_rwlock_t file_bcast_lock = PTHREAD_RWLOCK_INITIALIZER;
 static list_t *file_bcast_list = NULL;
@@ -3603,6 +3616,17 @@ static void _rpc_daemon_status(slurm_msg_t *msg)
 	resp->slurmd_logfile     = xstrdup(conf->logfile);
 	resp->version            = xstrdup(SLURM_VERSION_STRING);
 
+	resp->prep_hist_cnt = PREP_HIST_CNT;
+	resp->prolog_hist = xcalloc(PREP_HIST_CNT, sizeof(uint32_t));
+	resp->epilog_hist = xcalloc(PREP_HIST_CNT, sizeof(uint32_t));
+	slurm_mutex_lock(&prep_slot_mutex);
+	resp->prep_queued = prep_queued;
+	resp->prep_running = prep_running;
+	resp->prep_wait_max = prep_wait_max;
+	memcpy(resp->prolog_hist, prolog_hist, sizeof(prolog_hist));
+	memcpy(resp->epilog_hist, epilog_hist, sizeof(epilog_hist));
+	slurm_mutex_unlock(&prep_slot_mutex);
+
 	slurm_msg_t_copy(&resp_msg, msg);
 	resp_msg.msg_type = RESPONSE_SLURMD_STATUS;
 	resp_msg.data     = resp;
@@ -3615,7 +3639,7 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 	slurm_step_id_t *req = msg->data;
 	slurm_msg_t        resp_msg;
 	job_step_stat_t *resp = NULL;
-	int fd;
+	int fd = -1;
 	uint16_t protocol_version;
 	uid_t uid;
 
@@ -3623,19 +3647,31 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 	/* step completion messages are only allowed from other slurmstepd,
 	   so only root or SlurmUser is allowed here */
 
-	fd = stepd_connect(conf->spooldir, conf->node_name,
-			   req, &protocol_version);
-	if (fd == -1) {
+	resp = xmalloc(sizeof(job_step_stat_t));
+	resp->step_pids = xmalloc(sizeof(job_step_pids_t));
+	resp->step_pids->node_name = xstrdup(conf->node_name);
+	resp->return_code = SLURM_SUCCESS;
+
+	/*
+	 * Use the data of the last periodic poll published by the
+	 * slurmstepd if there is any, otherwise ask the slurmstepd.
+	 */
+	if (xstrcasestr(slurm_conf.job_acct_gather_params, "StatSnapshot") &&
+	    (stepd_stat_snapshot_read(conf->spooldir, conf->node_name, req,
+				      &uid, resp) == SLURM_SUCCESS)) {
+		log_flag(JAG, "%s: %ps from snapshot", __func__, req);
+	} else if ((fd = stepd_connect(conf->spooldir, conf->node_name,
+				       req, &protocol_version)) == -1) {
 		error("stepd_connect to %ps failed: %m", req);
 		slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
+		slurm_free_job_step_stat(resp);
 		return;
-	}
-
-	if ((uid = stepd_get_uid(fd, protocol_version)) == INFINITE) {
+	} else if ((uid = stepd_get_uid(fd, protocol_version)) == INFINITE) {
 		debug("stat_jobacct couldn't read from %ps: %m", req);
 		close(fd);
 		if (msg->conn_fd >= 0)
 			slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
+		slurm_free_job_step_stat(resp);
 		return;
 	}
 
@@ -3650,31 +3686,32 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 		if (msg->conn_fd >= 0) {
 			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
 			/* or bad in this case */
-			close(fd);
+			if (fd >= 0)
+				close(fd);
+			slurm_free_job_step_stat(resp);
 			return;
 		}
 	}
 
-	resp = xmalloc(sizeof(job_step_stat_t));
-	resp->step_pids = xmalloc(sizeof(job_step_pids_t));
-	resp->step_pids->node_name = xstrdup(conf->node_name);
 	slurm_msg_t_copy(&resp_msg, msg);
-	resp->return_code = SLURM_SUCCESS;
 
-	if (stepd_stat_jobacct(fd, protocol_version, req, resp)
-	    == SLURM_ERROR) {
-		debug("accounting for nonexistent %ps requested", req);
-	}
+	if (fd >= 0) {
+		if (stepd_stat_jobacct(fd, protocol_version, req, resp)
+		    == SLURM_ERROR) {
+			debug("accounting for nonexistent %ps requested", req);
+		}
 
-	/* FIX ME: This should probably happen in the
-	   stepd_stat_jobacct to get more information about the pids.
-	*/
-	if (stepd_list_pids(fd, protocol_version, &resp->step_pids->pid,
-			    &resp->step_pids->pid_cnt) == SLURM_ERROR) {
-		debug("No pids for nonexistent %ps requested", req);
-	}
+		/* FIX ME: This should probably happen in the
+		   stepd_stat_jobacct to get more information about the pids.
+		*/
+		if (stepd_list_pids(fd, protocol_version,
+				    &resp->step_pids->pid,
+				    &resp->step_pids->pid_cnt) == SLURM_ERROR) {
+			debug("No pids for nonexistent %ps requested", req);
+		}
 
-	close(fd);
+		close(fd);
+	}
 
 	resp_msg.msg_type     = RESPONSE_JOB_STEP_STAT;
 	resp_msg.data         = resp;
@@ -5649,6 +5686,57 @@ static void *_prolog_timer(void *x)
 	return NULL;
 }
 
+/*
+ * Wait for a free Prolog/Epilog slot. Running every script of a busy node at
+ * once only makes them compete with each other and with the jobs for the
+ * same CPUs, so at most conf->prep_script_max run at the same time.
+ */
+static void _prep_slot_get(void)
+{
+	struct timeval tv = { 0, 0 };
+	uint32_t wait_ms;
+
+	slurm_mutex_lock(&prep_slot_mutex);
+	if (conf->prep_script_max &&
+	    (prep_running >= conf->prep_script_max)) {
+		(void) slurm_delta_tv(&tv);
+		prep_queued++;
+		while (conf->prep_script_max &&
+		       (prep_running >= conf->prep_script_max))
+			slurm_cond_wait(&prep_slot_cond, &prep_slot_mutex);
+		prep_queued--;
+		wait_ms = slurm_delta_tv(&tv) / 1000;
+		prep_wait_max = MAX(prep_wait_max, wait_ms);
+		debug2("%s: waited %u ms for a prolog/epilog slot",
+		       __func__, wait_ms);
+	}
+	prep_running++;
+	slurm_mutex_unlock(&prep_slot_mutex);
+}
+
+static void _prep_slot_put(bool is_epilog, struct timeval *start)
+{
+	int inx = prep_hist_inx(slurm_delta_tv(start) / 1000);
+
+	slurm_mutex_lock(&prep_slot_mutex);
+	prep_running--;
+	if (is_epilog)
+		epilog_hist[inx]++;
+	else
+		prolog_hist[inx]++;
+	slurm_cond_signal(&prep_slot_cond);
+	slurm_mutex_unlock(&prep_slot_mutex);
+}
+
+extern void prep_slot_set_max(uint16_t max_cnt)
+{
+	slurm_mutex_lock(&prep_slot_mutex);
+	conf->prep_script_max = max_cnt;
+	/* A raised (or removed) limit may free several slots at once */
+	slurm_cond_broadcast(&prep_slot_cond);
+	slurm_mutex_unlock(&prep_slot_mutex);
+}
+
 static int
 _run_prolog(job_env_t *job_env, slurm_cred_t *cred, bool remove_running)
 {
@@ -5660,11 +5748,14 @@ _run_prolog(job_env_t *job_env, slurm_cred_t *cred, bool remove_running)
 	timer_struct_t  timer_struct;
 	bool prolog_fini = false;
 	bool script_lock = false;
+	struct timeval run_start = { 0, 0 };
 
+	_prep_slot_get();
 	if (slurm_conf.prolog_flags & PROLOG_FLAG_SERIAL) {
 		slurm_mutex_lock(&prolog_serial_mutex);
 		script_lock = true;
 	}
+	(void) slurm_delta_tv(&run_start);
 
 	timer_struct.job_id      = job_env->jobid;
 	timer_struct.msg_timeout = slurm_conf.msg_timeout;
@@ -5692,6 +5783,7 @@ _run_prolog(job_env_t *job_env, slurm_cred_t *cred, bool remove_running)
 	slurm_thread_join(timer_id);
 	if (script_lock)
 		slurm_mutex_unlock(&prolog_serial_mutex);
+	_prep_slot_put(false, &run_start);
 
 	return rc;
 }
@@ -5701,13 +5793,16 @@ static int _run_epilog(job_env_t *job_env, slurm_cred_t *cred)
 	time_t start_time = time(NULL);
 	int error_code, diff_time;
 	bool script_lock = false;
+	struct timeval run_start = { 0, 0 };
 
 	_wait_for_job_running_prolog(job_env->jobid);
 
+	_prep_slot_get();
 	if (slurm_conf.prolog_flags & PROLOG_FLAG_SERIAL) {
 		slurm_mutex_lock(&prolog_serial_mutex);
 		script_lock = true;
 	}
+	(void) slurm_delta_tv(&run_start);
 
 	error_code = prep_g_epilog(job_env, cred);
 
@@ -5719,6 +5814,7 @@ static int _run_epilog(job_env_t *job_env, slurm_cred_t *cred)
 
 	if (script_lock)
 		slurm_mutex_unlock(&prolog_serial_mutex);
+	_prep_slot_put(true, &run_start);
 
 	return error_code;
 }
@@ -68,4 +68,10 @@ void file_bcast_purge(void);
  */
 extern int ume_notify(void);
 
+/*
+ * Set the maximum number of Prolog/Epilog scripts to run at once and wake up
+ * any scripts waiting on the previous limit. 0 means no limit.
+ */
+extern void prep_slot_set_max(uint16_t max_cnt);
+
 #endif
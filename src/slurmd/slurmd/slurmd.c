@@ -948,9 +948,10 @@ _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 static void
 _read_config(void)
 {
-	char *bcast_address;
+	char *bcast_address, *tmp_ptr;
 	slurm_conf_t *cf = NULL;
 	int cc;
+	uint16_t prep_max;
 	bool cgroup_mem_confinement = false;
 #ifndef HAVE_FRONT_END
 	node_record_t *node_ptr;
@@ -1207,6 +1208,25 @@ _read_config(void)
 
 	conf->syslog_debug = cf->slurmd_syslog_debug;
 
+	prep_max = 0;
+	if ((tmp_ptr = xstrcasestr(cf->slurmd_params, "max_prep_script_cnt="))) {
+		char *end_ptr = NULL;
+		long max_cnt = strtol(tmp_ptr + 20, &end_ptr, 10);
+
+		if ((end_ptr == (tmp_ptr + 20)) ||
+		    (*end_ptr && (*end_ptr != ','))) {
+			error("Invalid SlurmdParameters max_prep_script_cnt, running Prolog/Epilog scripts without a limit");
+		} else {
+			if ((max_cnt < 0) || (max_cnt >= NO_VAL16)) {
+				max_cnt = MAX(MIN(max_cnt, NO_VAL16 - 1), 0);
+				error("SlurmdParameters max_prep_script_cnt out of range, using %ld",
+				      max_cnt);
+			}
+			prep_max = max_cnt;
+		}
+	}
+	prep_slot_set_max(prep_max);
+
 	conf->acct_freq_task = NO_VAL16;
 	cc = acct_gather_parse_freq(PROFILE_TASK, cf->job_acct_gather_freq);
 	if (cc != -1)
@@ -146,6 +146,8 @@ typedef struct slurmd_config {
 	pthread_cond_t	starting_steps_cond;
 	list_t *prolog_running_jobs;
 	pthread_cond_t	prolog_running_cond;
+	uint16_t	prep_script_max; /* max concurrent prolog/epilog
+					  * scripts, 0 is unlimited */
 	bool		print_gres;	/* Print gres info (-G) and exit */
 
 	uint8_t dynamic_type;		/* Dynamic node type */
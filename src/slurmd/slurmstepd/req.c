@@ -105,6 +105,7 @@ static int _handle_resume(int fd, stepd_step_rec_t *step, uid_t uid);
 static int _handle_terminate(int fd, stepd_step_rec_t *step, uid_t uid);
 static int _handle_completion(int fd, stepd_step_rec_t *step, uid_t uid);
 static int _handle_stat_jobacct(int fd, stepd_step_rec_t *step, uid_t uid);
+static void _publish_stat_snapshot(uint16_t frequency);
 static int _handle_task_info(int fd, stepd_step_rec_t *step);
 static int _handle_list_pids(int fd, stepd_step_rec_t *step);
 static int _handle_reconfig(int fd, stepd_step_rec_t *step, uid_t uid);
@@ -118,6 +119,16 @@ struct io_operations msg_socket_ops = {
 };
 
 static char *socket_name;
+
+/*
+ * Statistics snapshot for slurmd, see _publish_stat_snapshot(). It is
+ * written at most once every STAT_SNAPSHOT_INTERVAL seconds.
+ */
+#define STAT_SNAPSHOT_INTERVAL 10
+static pthread_mutex_t stat_snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *stat_snapshot_name = NULL;
+static stepd_step_rec_t *stat_snapshot_step = NULL;
+static time_t stat_snapshot_time = 0;
 static pthread_mutex_t suspend_mutex = PTHREAD_MUTEX_INITIALIZER;
 static bool suspended = false;
 
@@ -250,11 +261,23 @@ _domain_socket_create(const char *dir, const char *nodename,
 static void
 _domain_socket_destroy(int fd)
 {
+	char *name;
+
 	if (close(fd) < 0)
 		error("Unable to close domain socket: %m");
 
 	if (unlink(socket_name) == -1)
 		error("Unable to unlink domain socket `%s`: %m", socket_name);
+
+	jobacct_gather_set_poll_callback(NULL);
+	slurm_mutex_lock(&stat_snapshot_mutex);
+	name = stat_snapshot_name;
+	stat_snapshot_name = NULL;
+	stat_snapshot_step = NULL;
+	slurm_mutex_unlock(&stat_snapshot_mutex);
+	if (name && (unlink(name) == -1) && (errno != ENOENT))
+		error("Unable to unlink stat snapshot `%s`: %m", name);
+	xfree(name);
 }
 
 /* Wait for the job to be running (pids added) before continuing. */
@@ -318,6 +341,16 @@ msg_thr_create(stepd_step_rec_t *step)
 
 	slurm_thread_create(&step->msgid, _msg_thr_internal, step);
 
+	if (xstrcasestr(slurm_conf.job_acct_gather_params, "StatSnapshot")) {
+		slurm_mutex_lock(&stat_snapshot_mutex);
+		stat_snapshot_name = stepd_stat_snapshot_name(conf->spooldir,
+							      conf->node_name,
+							      &step->step_id);
+		stat_snapshot_step = step;
+		slurm_mutex_unlock(&stat_snapshot_mutex);
+		jobacct_gather_set_poll_callback(_publish_stat_snapshot);
+	}
+
 	return SLURM_SUCCESS;
 }
 
@@ -1842,30 +1875,19 @@ rwfail:	if (lock_set) {
 	return SLURM_ERROR;
 }
 
-static int
-_handle_stat_jobacct(int fd, stepd_step_rec_t *step, uid_t uid)
+/*
+ * Aggregate the accounting data of the step's tasks on this node.
+ * IN update_data - poll the processes first, see jobacct_gather_stat_task()
+ * OUT num_tasks - number of tasks included
+ * RET jobacctinfo_t, caller must jobacctinfo_destroy()
+ */
+static jobacctinfo_t *_get_step_jobacct(stepd_step_rec_t *step,
+					bool update_data, int *num_tasks)
 {
-	bool update_data = true;
-	jobacctinfo_t *jobacct = NULL;
+	jobacctinfo_t *jobacct = jobacctinfo_create(NULL);
 	jobacctinfo_t *temp_jobacct = NULL;
-	int num_tasks = 0;
-	uint64_t msg_timeout_us;
-	DEF_TIMERS;
-	START_TIMER;
-
-	debug("_handle_stat_jobacct for %ps", &step->step_id);
-
-	debug3("  uid = %u", uid);
-	if (uid != step->uid && !_slurm_authorized_user(uid)) {
-		debug("stat jobacct from uid %u for %ps owned by uid %u",
-		      uid, &step->step_id, step->uid);
-		/* Send NULL */
-		jobacctinfo_setinfo(jobacct, JOBACCT_DATA_PIPE, &fd,
-				    SLURM_PROTOCOL_VERSION);
-		return SLURM_ERROR;
-	}
 
-	jobacct = jobacctinfo_create(NULL);
+	*num_tasks = 0;
 	debug3("num tasks = %d", step->node_tasks);
 
 	/*
@@ -1880,7 +1902,7 @@ _handle_stat_jobacct(int fd, stepd_step_rec_t *step, uid_t uid)
 		 * We only have one task in the extern step on each node,
 		 * despite many pids may have been adopted.
 		 */
-		num_tasks = 1;
+		*num_tasks = 1;
 		proctrack_g_get_pids(step->cont_id, &pids, &npids);
 
 		for (int i = 0; i < npids; i++) {
@@ -1906,11 +1928,92 @@ _handle_stat_jobacct(int fd, stepd_step_rec_t *step, uid_t uid)
 			if (temp_jobacct) {
 				jobacctinfo_aggregate(jobacct, temp_jobacct);
 				jobacctinfo_destroy(temp_jobacct);
-				num_tasks++;
+				(*num_tasks)++;
 			}
 		}
 	}
 
+	return jobacct;
+}
+
+/*
+ * Called by the jobacct_gather polling thread after each periodic poll with
+ * JobAcctGatherParams=StatSnapshot. Write the data just gathered where slurmd
+ * can read it, so it can answer sstat without a request to this slurmstepd
+ * (and without walking the step's processes again).
+ */
+static void _publish_stat_snapshot(uint16_t frequency)
+{
+	stepd_step_rec_t *step;
+	jobacctinfo_t *jobacct;
+	pid_t *pids = NULL;
+	uint32_t *pids32 = NULL;
+	int num_tasks = 0, npids = 0;
+	time_t now = time(NULL);
+
+	slurm_mutex_lock(&stat_snapshot_mutex);
+	if (!(step = stat_snapshot_step) ||
+	    ((now - stat_snapshot_time) < STAT_SNAPSHOT_INTERVAL)) {
+		slurm_mutex_unlock(&stat_snapshot_mutex);
+		return;
+	}
+	stat_snapshot_time = now;
+
+	jobacct = _get_step_jobacct(step, false, &num_tasks);
+	if (!num_tasks) {
+		/* Nothing gathered yet or any more, use the socket instead */
+		(void) unlink(stat_snapshot_name);
+		slurm_mutex_unlock(&stat_snapshot_mutex);
+		jobacctinfo_destroy(jobacct);
+		return;
+	}
+
+	proctrack_g_get_pids(step->cont_id, &pids, &npids);
+	if (npids > 0) {
+		pids32 = xcalloc(npids, sizeof(uint32_t));
+		for (int i = 0; i < npids; i++)
+			pids32[i] = (uint32_t) pids[i];
+	}
+
+	/*
+	 * The next snapshot follows the first poll at least
+	 * STAT_SNAPSHOT_INTERVAL seconds from now, after which this one is
+	 * considered stale.
+	 */
+	(void) stepd_stat_snapshot_write(stat_snapshot_name, step->uid,
+					 MIN(frequency + STAT_SNAPSHOT_INTERVAL,
+					     NO_VAL16 - 1),
+					 jobacct, num_tasks, pids32, npids);
+	slurm_mutex_unlock(&stat_snapshot_mutex);
+
+	jobacctinfo_destroy(jobacct);
+	xfree(pids32);
+	xfree(pids);
+}
+
+static int
+_handle_stat_jobacct(int fd, stepd_step_rec_t *step, uid_t uid)
+{
+	jobacctinfo_t *jobacct = NULL;
+	int num_tasks = 0;
+	uint64_t msg_timeout_us;
+	DEF_TIMERS;
+	START_TIMER;
+
+	debug("_handle_stat_jobacct for %ps", &step->step_id);
+
+	debug3("  uid = %u", uid);
+	if (uid != step->uid && !_slurm_authorized_user(uid)) {
+		debug("stat jobacct from uid %u for %ps owned by uid %u",
+		      uid, &step->step_id, step->uid);
+		/* Send NULL */
+		jobacctinfo_setinfo(jobacct, JOBACCT_DATA_PIPE, &fd,
+				    SLURM_PROTOCOL_VERSION);
+		return SLURM_ERROR;
+	}
+
+	jobacct = _get_step_jobacct(step, true, &num_tasks);
+
 	jobacctinfo_setinfo(jobacct, JOBACCT_DATA_PIPE, &fd,
 			    SLURM_PROTOCOL_VERSION);
 	safe_write(fd, &num_tasks, sizeof(int));
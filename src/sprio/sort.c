@@ -36,6 +36,7 @@
 
 #include <sys/types.h>
 
+#include "src/common/sort_keys.h"
 #include "src/common/uid.h"
 #include "src/common/xstring.h"
 
@@ -51,6 +52,19 @@
 /* Global variables */
 static bool sort_descend;
 
+/* A job and the values its sort keys need, computed once per job */
+typedef struct {
+	priority_factors_object_t *job;
+	int inx;		/* position in the unsorted list */
+	double job_prio;
+	double tres_prio;
+	char *user_name;
+} sort_rec_t;
+
+/* Sort keys in the reverse of the order given in params.sort */
+static sort_keys_t sort_keys;
+static bool need_job_prio, need_tres_prio, need_user_name;
+
 /* Local sort functions */
 static int _sort_by_cluster_name(void *v1, void *v2);
 static int _sort_by_job_id(void *v1, void *v2);
@@ -67,16 +81,25 @@ static int _sort_by_qos_prio(void *v1, void *v2);
 static int _sort_by_job_prio(void *v1, void *v2);
 static int _sort_by_tres_prio(void *v1, void *v2);
 
+static void _add_sort_key(int (*cmp)(void *v1, void *v2));
+static void _set_sort_rec(sort_rec_t *rec, priority_factors_object_t *job,
+			  int inx);
+static int _sort_by_keys(const void *v1, const void *v2);
 
 extern void sort_job_list(list_t *job_list)
 {
-	int i;
+	int i, job_cnt;
 	char c;
+	priority_factors_object_t *job;
+	sort_rec_t *recs;
+
 	if (params.sort == NULL)
 		params.sort = xstrdup(DEFAULT_SORT); /* default: job priority */
+	need_job_prio = need_tres_prio = need_user_name = false;
+
 	/*
-	 * parse sort spec string from end, so the sorts happen in reverse
-	 * order.
+	 * parse sort spec string from end, so the keys are collected in
+	 * reverse order.
 	 */
 	for (i = strlen(params.sort); i --> 0;) {
 		c = params.sort[i];
@@ -94,53 +117,56 @@ extern void sort_job_list(list_t *job_list)
 		 */
 		switch (c) {
 		case 'c': /* sort by cluster name */
-			list_sort(job_list, _sort_by_cluster_name);
+			_add_sort_key(_sort_by_cluster_name);
 			break;
 		case 'i': /* sort by job id */
-			list_sort(job_list, _sort_by_job_id);
+			_add_sort_key(_sort_by_job_id);
 			break;
 		case 'N': /* sort by nice level ??? */
-			list_sort(job_list, _sort_by_nice_level);
+			_add_sort_key(_sort_by_nice_level);
 			break;
 		case 'n': /* sort by QOS name */
-			list_sort(job_list, _sort_by_qos_name);
+			_add_sort_key(_sort_by_qos_name);
 			break;
 		case 'o': /* sort by account name */
-			list_sort(job_list, _sort_by_account);
+			_add_sort_key(_sort_by_account);
 			break;
 		case 'r': /* sort by partition name */
-			list_sort(job_list, _sort_by_partition);
+			_add_sort_key(_sort_by_partition);
 			break;
 		case 'u': /* sort by username */
-			list_sort(job_list, _sort_by_username);
+			need_user_name = true;
+			_add_sort_key(_sort_by_username);
 			break;
 		case 'A': /* sort by age priority */
 		case 'a':
-			list_sort(job_list, _sort_by_age_prio);
+			_add_sort_key(_sort_by_age_prio);
 			break;
 		case 'F': /* sort by fair share priority */
 		case 'f':
-			list_sort(job_list, _sort_by_fairshare_prio);
+			_add_sort_key(_sort_by_fairshare_prio);
 			break;
 		case 'J': /* sort by job size priority */
 		case 'j':
-			list_sort(job_list, _sort_by_jobsize_prio);
+			_add_sort_key(_sort_by_jobsize_prio);
 			break;
 		case 'P': /* sort by partition priority */
 		case 'p':
-			list_sort(job_list, _sort_by_partition_prio);
+			_add_sort_key(_sort_by_partition_prio);
 			break;
 		case 'Q': /* sort by qos priority */
 		case 'q':
-			list_sort(job_list, _sort_by_qos_prio);
+			_add_sort_key(_sort_by_qos_prio);
 			break;
 		case 'T': /* sort by TRES priority */
 		case 't':
-			list_sort(job_list, _sort_by_tres_prio);
+			need_tres_prio = true;
+			_add_sort_key(_sort_by_tres_prio);
 			break;
 		case 'Y': /* sort by job priority */
 		case 'y':
-			list_sort(job_list, _sort_by_job_prio);
+			need_job_prio = true;
+			_add_sort_key(_sort_by_job_prio);
 			break;
 		default:
 			error("Invalid sort specification: %c",
@@ -148,18 +174,79 @@ extern void sort_job_list(list_t *job_list)
 			exit(1);
 		}
 	}
+
+	/*
+	 * Sort an array of jobs with their precomputed values by every key in
+	 * a single pass, then put the jobs back in the list in that order.
+	 */
+	job_cnt = list_count(job_list);
+	recs = xcalloc(job_cnt, sizeof(sort_rec_t));
+	for (i = 0; (job = list_pop(job_list)); i++)
+		_set_sort_rec(&recs[i], job, i);
+	qsort(recs, job_cnt, sizeof(sort_rec_t), _sort_by_keys);
+	for (i = 0; i < job_cnt; i++)
+		list_append(job_list, recs[i].job);
+
+	xfree(recs);
+	sort_keys_clear(&sort_keys);
 }
 
 
 /*****************************************************************************
  * Local utility functions
  *****************************************************************************/
+static void _add_sort_key(int (*cmp)(void *v1, void *v2))
+{
+	sort_keys_add(&sort_keys, cmp, sort_descend);
+}
+
+static double _get_tres_prio(priority_factors_object_t *job)
+{
+	double sum = 0;
+
+	if (!job->prio_factors)
+		return 0;
+	for (int i = 0; i < job->prio_factors->tres_cnt; i++)
+		sum += job->prio_factors->priority_tres[i];
+
+	return sum;
+}
+
+static void _set_sort_rec(sort_rec_t *rec, priority_factors_object_t *job,
+			  int inx)
+{
+	rec->job = job;
+	rec->inx = inx;
+	if (need_job_prio)
+		rec->job_prio = get_priority_from_factors(job);
+	if (need_tres_prio)
+		rec->tres_prio = _get_tres_prio(job);
+	if (need_user_name)
+		rec->user_name = uid_to_string_cached((uid_t) job->user_id);
+}
+
+/*
+ * Compare by every key, most significant first. Jobs that are equal on all
+ * keys keep their original order, as qsort() is not stable.
+ */
+static int _sort_by_keys(const void *v1, const void *v2)
+{
+	int cmp = sort_keys_cmp(&sort_keys, &sort_descend, (void *) v1,
+				(void *) v2);
+
+	if (!cmp)
+		cmp = CMP_INT(((sort_rec_t *) v1)->inx,
+			      ((sort_rec_t *) v2)->inx);
+
+	return cmp;
+}
+
 static inline void _get_job_prio_from_void(priority_factors_object_t **j1,
 					   priority_factors_object_t **j2,
 					   void *v1, void *v2)
 {
-	*j1 = *(priority_factors_object_t **) v1;
-	*j2 = *(priority_factors_object_t **) v2;
+	*j1 = ((sort_rec_t *) v1)->job;
+	*j2 = ((sort_rec_t *) v2)->job;
 }
 
 static inline double _compare_double(double a, double b)
@@ -244,14 +331,9 @@ static int _sort_by_partition(void *v1, void *v2)
 static int _sort_by_username(void *v1, void *v2)
 {
 	int cmp;
-	priority_factors_object_t *job1, *job2;
-	char *name1, *name2;
-
-	_get_job_prio_from_void(&job1, &job2, v1, v2);
+	sort_rec_t *rec1 = v1, *rec2 = v2;
 
-	name1 = uid_to_string_cached((uid_t) job1->user_id);
-	name2 = uid_to_string_cached((uid_t) job2->user_id);
-	cmp = xstrcmp(name1, name2);
+	cmp = xstrcmp(rec1->user_name, rec2->user_name);
 	return COND_NEGATE(sort_descend, cmp);
 }
 
@@ -333,36 +415,18 @@ static int _sort_by_qos_prio(void *v1, void *v2)
 
 static int _sort_by_tres_prio(void *v1, void *v2)
 {
-	int cmp, i;
-	priority_factors_object_t *job1, *job2;
-	double job1_sum, job2_sum;
-	int val1, val2;
-
-	_get_job_prio_from_void(&job1, &job2, v1, v2);
-
-	val1 = job1->prio_factors ? job1->prio_factors->tres_cnt : 0;
-	val2 = job1->prio_factors ? job2->prio_factors->tres_cnt : 0;
-
-	for (i = 0, job1_sum = 0; i < val1; i++)
-		job1_sum += job1->prio_factors->priority_tres[i];
-	for (i = 0, job2_sum = 0; i < val2; i++)
-		job2_sum += job2->prio_factors->priority_tres[i];
+	int cmp;
+	sort_rec_t *rec1 = v1, *rec2 = v2;
 
-	cmp = _compare_double(job1_sum, job2_sum);
+	cmp = _compare_double(rec1->tres_prio, rec2->tres_prio);
 	return COND_NEGATE(sort_descend, cmp);
 }
 
 static int _sort_by_job_prio(void *v1, void *v2)
 {
 	int cmp;
-	priority_factors_object_t *job1, *job2;
-	double j1_prio, j2_prio;
-
-	_get_job_prio_from_void(&job1, &job2, v1, v2);
+	sort_rec_t *rec1 = v1, *rec2 = v2;
 
-	j1_prio = get_priority_from_factors(job1);
-	j2_prio = get_priority_from_factors(job2);
-	cmp = _compare_double(j1_prio, j2_prio);
+	cmp = _compare_double(rec1->job_prio, rec2->job_prio);
 	return COND_NEGATE(sort_descend, cmp);
 }
-
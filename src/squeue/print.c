@@ -131,7 +131,6 @@ extern void print_jobs_array(job_info_t *jobs, int size, list_t *format)
 
 	_combine_pending_array_tasks(l);
 	_part_state_free();
-	sort_jobs_by_start_time (l);
 	sort_job_list (l);
 
 	/* Print the jobs of interest */
@@ -784,9 +783,8 @@ int _print_job_group_name(job_info_t * job, int width, bool right, char* suffix)
 	if (job == NULL)	/* Print the Header instead */
 		_print_str("GROUP", width, right, true);
 	else {
-		char *group = gid_to_string(job->group_id);
+		char *group = gid_to_string_cached((gid_t) job->group_id);
 		_print_str(group, width, right, true);
-		xfree(group);
 	}
 	if (suffix)
 		printf("%s", suffix);
@@ -42,6 +42,7 @@
 
 #include "slurm/slurm.h"
 
+#include "src/common/hostlist.h"
 #include "src/common/list.h"
 
 #define FORMAT_STRING_SIZE 32
@@ -67,6 +68,12 @@ typedef struct squeue_job_rec {
 	job_info_t *	job_ptr;
 	char *		part_name;
 	uint32_t	part_prio;
+
+	/* Values computed once by sort_job_list() rather than per compare */
+	char *		group_name;	/* from gid_to_string_cached() */
+	char *		user_name;	/* from uid_to_string_cached() */
+	hostlist_t *	sort_nodes;	/* sorted copy of job_ptr->nodes */
+	long		time_used;
 } squeue_job_rec_t;
 
 long job_time_used(job_info_t * job_ptr);
@@ -37,10 +37,10 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
-#include <grp.h>
 #include <pwd.h>
 #include <sys/types.h>
 
+#include "src/common/sort_keys.h"
 #include "src/common/uid.h"
 #include "src/common/xstring.h"
 #include "src/squeue/print.h"
@@ -52,6 +52,17 @@
 
 static bool reverse_order;
 
+/* Sort keys in the reverse of the order given in params.sort */
+static sort_keys_t sort_keys;
+
+/* Record fields that the requested job sort keys use */
+static bool need_group_name, need_node_list, need_time_used, need_user_name;
+
+static void _add_sort_key(ListCmpF cmp);
+static void _clear_job_sort_fields(List job_list);
+static void _set_job_sort_fields(List job_list);
+static int _sort_by_keys(void *void1, void *void2);
+
 static void _get_job_info_from_void(job_info_t **j1, job_info_t **j2, void *v1, void *v2);
 static void _get_step_info_from_void(job_step_info_t **j1, job_step_info_t **j2, void *v1, void *v2);
 static int _sort_job_by_batch_host(void *void1, void *void2);
@@ -92,7 +103,7 @@ static int _sort_step_by_time_limit(void *void1, void *void2);
 static int _sort_step_by_time_used(void *void1, void *void2);
 static int _sort_step_by_user_id(void *void1, void *void2);
 static int _sort_step_by_user_name(void *void1, void *void2);
-static int _sort_by_node_list(char *nodes1, char *nodes2);
+static int _sort_by_node_list(hostlist_t *hostlist1, hostlist_t *hostlist2);
 
 
 static time_t now;
@@ -109,6 +120,14 @@ void sort_job_list(List job_list)
 	if (params.sort == NULL)
 		params.sort = xstrdup("P,t,-p"); /* Partition,state,priority */
 
+	sort_keys_clear(&sort_keys);
+	need_group_name = need_node_list = false;
+	need_time_used = need_user_name = false;
+
+	/* Jobs which compare equal on every key are ordered by start time */
+	reverse_order = true;
+	_add_sort_key(_sort_job_by_time_start);
+
 	for (i=(strlen(params.sort)-1); i >= 0; i--) {
 		reverse_order = false;
 		if ((params.sort[i] == ',') ||
@@ -125,89 +144,92 @@ void sort_job_list(List job_list)
 			    (params.sort[i - CLUSTER_NAME_LEN] == '-'))
 				reverse_order = true;
 
-			list_sort(job_list, _sort_job_by_cluster_name);
+			_add_sort_key(_sort_job_by_cluster_name);
 			i -= CLUSTER_NAME_LEN - 1;
 		} else if (params.sort[i] == 'B')
-			list_sort(job_list, _sort_job_by_batch_host);
+			_add_sort_key(_sort_job_by_batch_host);
 		else if (params.sort[i] == 'b')	/* Vestigial gres sort */
 			info("Invalid sort specification: b");
 		else if (params.sort[i] == 'c')
 			;	/* sort_job_by_min_cpus_per_node */
 		else if (params.sort[i] == 'C')
-			list_sort(job_list, _sort_job_by_num_cpus);
+			_add_sort_key(_sort_job_by_num_cpus);
 		else if (params.sort[i] == 'd')
-			list_sort(job_list, _sort_job_by_min_tmp_disk);
+			_add_sort_key(_sort_job_by_min_tmp_disk);
 		else if (params.sort[i] == 'D')
-			list_sort(job_list, _sort_job_by_num_nodes);
+			_add_sort_key(_sort_job_by_num_nodes);
 		else if (params.sort[i] == 'e')
-			list_sort(job_list, _sort_job_by_time_end);
+			_add_sort_key(_sort_job_by_time_end);
 		else if (params.sort[i] == 'f')
 			;	/* sort_job_by_featuers */
-		else if (params.sort[i] == 'g')
-			list_sort(job_list, _sort_job_by_group_name);
-		else if (params.sort[i] == 'G')
-			list_sort(job_list, _sort_job_by_group_id);
+		else if (params.sort[i] == 'g') {
+			need_group_name = true;
+			_add_sort_key(_sort_job_by_group_name);
+		} else if (params.sort[i] == 'G')
+			_add_sort_key(_sort_job_by_group_id);
 		else if (params.sort[i] == 'h')
 			;	/* sort_job_by_over_subscribe, not supported */
 		else if (params.sort[i] == 'H')
-			list_sort(job_list, _sort_job_by_sockets);
+			_add_sort_key(_sort_job_by_sockets);
 		else if (params.sort[i] == 'i')
-			list_sort(job_list, _sort_job_by_id);
+			_add_sort_key(_sort_job_by_id);
 		else if (params.sort[i] == 'I')
-			list_sort(job_list, _sort_job_by_cores);
+			_add_sort_key(_sort_job_by_cores);
 		else if (params.sort[i] == 'j')
-			list_sort(job_list, _sort_job_by_name);
+			_add_sort_key(_sort_job_by_name);
 		else if (params.sort[i] == 'J')
-			list_sort(job_list, _sort_job_by_threads);
+			_add_sort_key(_sort_job_by_threads);
 		else if (params.sort[i] == 'l')
-			list_sort(job_list, _sort_job_by_time_limit);
-		else if (params.sort[i] == 'L')
-			list_sort(job_list, _sort_job_by_time_left);
-		else if (params.sort[i] == 'm')
-			list_sort(job_list, _sort_job_by_min_memory);
-		else if (params.sort[i] == 'M')
-			list_sort(job_list, _sort_job_by_time_used);
-		else if (params.sort[i] == 'n')
+			_add_sort_key(_sort_job_by_time_limit);
+		else if (params.sort[i] == 'L') {
+			need_time_used = true;
+			_add_sort_key(_sort_job_by_time_left);
+		} else if (params.sort[i] == 'm')
+			_add_sort_key(_sort_job_by_min_memory);
+		else if (params.sort[i] == 'M') {
+			need_time_used = true;
+			_add_sort_key(_sort_job_by_time_used);
+		} else if (params.sort[i] == 'n')
 			;	/* sort_job_by_nodes_requested */
-		else if (params.sort[i] == 'N')
-			list_sort(job_list, _sort_job_by_node_list);
-		else if (params.sort[i] == 'O')
+		else if (params.sort[i] == 'N') {
+			need_node_list = true;
+			_add_sort_key(_sort_job_by_node_list);
+		} else if (params.sort[i] == 'O')
 			;	/* sort_job_by_contiguous */
 		else if (params.sort[i] == 'p')
-			list_sort(job_list, _sort_job_by_priority);
+			_add_sort_key(_sort_job_by_priority);
 		else if (params.sort[i] == 'P')
-			list_sort(job_list, _sort_job_by_partition);
+			_add_sort_key(_sort_job_by_partition);
 		else if (params.sort[i] == 'Q')
-			list_sort(job_list, _sort_job_by_priority);
+			_add_sort_key(_sort_job_by_priority);
 		else if (params.sort[i] == 'S')
-			list_sort(job_list, _sort_job_by_time_start);
+			_add_sort_key(_sort_job_by_time_start);
 		else if (params.sort[i] == 't')
-			list_sort(job_list, _sort_job_by_state_compact);
+			_add_sort_key(_sort_job_by_state_compact);
 		else if (params.sort[i] == 'T')
-			list_sort(job_list, _sort_job_by_state);
-		else if (params.sort[i] == 'u')
-			list_sort(job_list, _sort_job_by_user_name);
-		else if (params.sort[i] == 'U')
-			list_sort(job_list, _sort_job_by_user_id);
+			_add_sort_key(_sort_job_by_state);
+		else if (params.sort[i] == 'u') {
+			need_user_name = true;
+			_add_sort_key(_sort_job_by_user_name);
+		} else if (params.sort[i] == 'U')
+			_add_sort_key(_sort_job_by_user_id);
 		else if (params.sort[i] == 'v')
-			list_sort(job_list, _sort_job_by_reservation);
+			_add_sort_key(_sort_job_by_reservation);
 		else if (params.sort[i] == 'V')
-			list_sort(job_list, _sort_job_by_time_submit);
+			_add_sort_key(_sort_job_by_time_submit);
 		else if (params.sort[i] == 'z')
-			list_sort(job_list, _sort_job_by_num_sct);
+			_add_sort_key(_sort_job_by_num_sct);
 		else {
 			error("Invalid sort specification: %c",
 			      params.sort[i]);
 			exit(1);
 		}
 	}
-}
 
-void sort_jobs_by_start_time (List jobs)
-{
-	reverse_order = true;
-	list_sort (jobs, _sort_job_by_time_start);
-	return;
+	_set_job_sort_fields(job_list);
+	list_sort(job_list, _sort_by_keys);
+	_clear_job_sort_fields(job_list);
+	sort_keys_clear(&sort_keys);
 }
 
 void sort_step_list(List step_list)
@@ -217,6 +239,8 @@ void sort_step_list(List step_list)
 
 	if (params.sort == NULL)
 		params.sort = xstrdup("P,i");	/* Partition, step id */
+
+	sort_keys_clear(&sort_keys);
 	for (i=(strlen(params.sort)-1); i >= 0; i--) {
 		reverse_order = false;
 		if ((params.sort[i] == ',') ||
@@ -232,28 +256,94 @@ void sort_step_list(List step_list)
 			    (params.sort[i - CLUSTER_NAME_LEN] == '-'))
 				reverse_order = true;
 
-			list_sort(step_list, _sort_step_by_cluster_name);
+			_add_sort_key(_sort_step_by_cluster_name);
 			i -= CLUSTER_NAME_LEN - 1;
 		}
 		else if (params.sort[i] == 'b')	/* Vestigial gres sort */
 			info("Invalid sort specification: b");
 		else if (params.sort[i] == 'i')
-			list_sort(step_list, _sort_step_by_id);
+			_add_sort_key(_sort_step_by_id);
 		else if (params.sort[i] == 'N')
-			list_sort(step_list, _sort_step_by_node_list);
+			_add_sort_key(_sort_step_by_node_list);
 		else if (params.sort[i] == 'P')
-			list_sort(step_list, _sort_step_by_partition);
+			_add_sort_key(_sort_step_by_partition);
 		else if (params.sort[i] == 'l')
-			list_sort(step_list, _sort_step_by_time_limit);
+			_add_sort_key(_sort_step_by_time_limit);
 		else if (params.sort[i] == 'S')
-			list_sort(step_list, _sort_step_by_time_start);
+			_add_sort_key(_sort_step_by_time_start);
 		else if (params.sort[i] == 'M')
-			list_sort(step_list, _sort_step_by_time_used);
+			_add_sort_key(_sort_step_by_time_used);
 		else if (params.sort[i] == 'u')
-			list_sort(step_list, _sort_step_by_user_name);
+			_add_sort_key(_sort_step_by_user_name);
 		else if (params.sort[i] == 'U')
-			list_sort(step_list, _sort_step_by_user_id);
+			_add_sort_key(_sort_step_by_user_id);
 	}
+
+	list_sort(step_list, _sort_by_keys);
+	sort_keys_clear(&sort_keys);
+}
+
+/*****************************************************************************
+ * Local Sort Key Functions
+ *****************************************************************************/
+static void _add_sort_key(ListCmpF cmp)
+{
+	sort_keys_add(&sort_keys, cmp, reverse_order);
+}
+
+/*
+ * Compare by every key in a single pass, most significant key first. This
+ * replaces one list_sort() per key, which relied on qsort() being stable.
+ */
+static int _sort_by_keys(void *void1, void *void2)
+{
+	return sort_keys_cmp(&sort_keys, &reverse_order, void1, void2);
+}
+
+static int _set_job_sort_fields_internal(void *x, void *arg)
+{
+	squeue_job_rec_t *job_rec_ptr = x;
+	job_info_t *job_ptr = job_rec_ptr->job_ptr;
+
+	if (need_group_name)
+		job_rec_ptr->group_name =
+			gid_to_string_cached((gid_t) job_ptr->group_id);
+	if (need_user_name)
+		job_rec_ptr->user_name =
+			uid_to_string_cached((uid_t) job_ptr->user_id);
+	if (need_node_list) {
+		job_rec_ptr->sort_nodes = hostlist_create(job_ptr->nodes);
+		hostlist_sort(job_rec_ptr->sort_nodes);
+	}
+	if (need_time_used)
+		job_rec_ptr->time_used = job_time_used(job_ptr);
+
+	return 0;
+}
+
+/*
+ * Resolve names and build node lists once per job before sorting, rather
+ * than twice for every comparison.
+ */
+static void _set_job_sort_fields(List job_list)
+{
+	list_for_each(job_list, _set_job_sort_fields_internal, NULL);
+}
+
+static int _clear_job_sort_fields_internal(void *x, void *arg)
+{
+	squeue_job_rec_t *job_rec_ptr = x;
+
+	job_rec_ptr->group_name = NULL;
+	job_rec_ptr->user_name = NULL;
+	FREE_NULL_HOSTLIST(job_rec_ptr->sort_nodes);
+
+	return 0;
+}
+
+static void _clear_job_sort_fields(List job_list)
+{
+	list_for_each(job_list, _clear_job_sort_fields_internal, NULL);
 }
 
 /*****************************************************************************
@@ -291,6 +381,13 @@ static inline int _diff_uint64(uint64_t value_1, uint64_t value_2)
 		return -1;
 	return 0;
 }
+static void _get_job_rec_from_void(squeue_job_rec_t **r1,
+				   squeue_job_rec_t **r2,
+				   void *void1, void *void2)
+{
+	*r1 = *(squeue_job_rec_t **)void1;
+	*r2 = *(squeue_job_rec_t **)void2;
+}
 static void _get_job_info_from_void(job_info_t **j1, job_info_t **j2,
 				    void *void1, void *void2)
 {
@@ -368,17 +465,12 @@ static int _sort_job_by_group_id(void *void1, void *void2)
 static int _sort_job_by_group_name(void *void1, void *void2)
 {
 	int diff;
-	job_info_t *job1;
-	job_info_t *job2;
-	char *name1, *name2;
+	squeue_job_rec_t *rec1;
+	squeue_job_rec_t *rec2;
 
-	_get_job_info_from_void(&job1, &job2, void1, void2);
+	_get_job_rec_from_void(&rec1, &rec2, void1, void2);
 
-	name1 = gid_to_string(job1->group_id);
-	name2 = gid_to_string(job2->group_id);
-	diff = xstrcmp(name1, name2);
-	xfree(name1);
-	xfree(name2);
+	diff = xstrcmp(rec1->group_name, rec2->group_name);
 
 	if (reverse_order)
 		diff = -diff;
@@ -448,39 +540,46 @@ static int _sort_job_by_name(void *void1, void *void2)
 
 static int _sort_job_by_node_list(void *void1, void *void2)
 {
-	job_info_t *job1, *job2;
-	_get_job_info_from_void(&job1, &job2, void1, void2);
-	return _sort_by_node_list(job1->nodes, job2->nodes);
+	squeue_job_rec_t *rec1, *rec2;
+	_get_job_rec_from_void(&rec1, &rec2, void1, void2);
+	return _sort_by_node_list(rec1->sort_nodes, rec2->sort_nodes);
 }
 
 static int _sort_step_by_node_list(void *void1, void *void2)
 {
+	int diff;
 	job_step_info_t *step1, *step2;
+	hostlist_t *hostlist1, *hostlist2;
+
 	_get_step_info_from_void(&step1, &step2, void1, void2);
-	return _sort_by_node_list(step1->nodes, step2->nodes);
+
+	hostlist1 = hostlist_create(step1->nodes);
+	hostlist_sort(hostlist1);
+	hostlist2 = hostlist_create(step2->nodes);
+	hostlist_sort(hostlist2);
+
+	diff = _sort_by_node_list(hostlist1, hostlist2);
+
+	hostlist_destroy(hostlist1);
+	hostlist_destroy(hostlist2);
+	return diff;
 }
 
-static int _sort_by_node_list(char *nodes1, char *nodes2)
+/* hostlist1 and hostlist2 must already be sorted */
+static int _sort_by_node_list(hostlist_t *hostlist1, hostlist_t *hostlist2)
 {
 	int diff = 0;
-	hostlist_t *hostlist1, *hostlist2;
 #if	PURE_ALPHA_SORT
 	char *val1, *val2;
 	char *ptr1, *ptr2;
-#endif
-	hostlist1 = hostlist_create(nodes1);
-	hostlist_sort(hostlist1);
-	hostlist2 = hostlist_create(nodes2);
-	hostlist_sort(hostlist2);
 
-#if	PURE_ALPHA_SORT
-	val1 = hostlist_shift(hostlist1);
+	val1 = hostlist_nth(hostlist1, 0);
 	if (val1)
 		ptr1 = val1;
 	else
 		ptr1 = "";
 
-	val2 = hostlist_shift(hostlist2);
+	val2 = hostlist_nth(hostlist2, 0);
 	if (val2)
 		ptr2 = val2;
 	else
@@ -498,8 +597,6 @@ static int _sort_by_node_list(char *nodes1, char *nodes2)
 	 */
 	diff = hostlist_cmp_first(hostlist1, hostlist2);
 #endif
-	hostlist_destroy(hostlist1);
-	hostlist_destroy(hostlist2);
 
 	if (reverse_order)
 		diff = -diff;
@@ -689,20 +786,24 @@ static int _sort_job_by_time_end(void *void1, void *void2)
 static int _sort_job_by_time_left(void *void1, void *void2)
 {
 	int diff;
+	squeue_job_rec_t *rec1;
+	squeue_job_rec_t *rec2;
 	job_info_t *job1;
 	job_info_t *job2;
 	time_t time1, time2;
 
-	_get_job_info_from_void(&job1, &job2, void1, void2);
+	_get_job_rec_from_void(&rec1, &rec2, void1, void2);
+	job1 = rec1->job_ptr;
+	job2 = rec2->job_ptr;
 
 	if ((job1->time_limit == INFINITE) || (job1->time_limit == NO_VAL))
 		time1 = INFINITE;
 	else
-		time1 = job1->time_limit * 60 - job_time_used(job1);
+		time1 = job1->time_limit * 60 - rec1->time_used;
 	if ((job2->time_limit == INFINITE) || (job2->time_limit == NO_VAL))
 		time2 = INFINITE;
 	else
-		time2 = job2->time_limit * 60 - job_time_used(job2);
+		time2 = job2->time_limit * 60 - rec2->time_used;
 	diff = _diff_time(time1, time2);
 
 	if (reverse_order)
@@ -774,15 +875,12 @@ static int _sort_job_by_time_start(void *void1, void *void2)
 static int _sort_job_by_time_used(void *void1, void *void2)
 {
 	int diff;
-	job_info_t *job1;
-	job_info_t *job2;
-	long time1, time2;
+	squeue_job_rec_t *rec1;
+	squeue_job_rec_t *rec2;
 
-	_get_job_info_from_void(&job1, &job2, void1, void2);
+	_get_job_rec_from_void(&rec1, &rec2, void1, void2);
 
-	time1 = job_time_used(job1);
-	time2 = job_time_used(job2);
-	diff = _diff_long(time1, time2);
+	diff = _diff_long(rec1->time_used, rec2->time_used);
 
 	if (reverse_order)
 		diff = -diff;
@@ -840,15 +938,12 @@ static int _sort_job_by_user_id(void *void1, void *void2)
 static int _sort_job_by_user_name(void *void1, void *void2)
 {
 	int diff;
-	job_info_t *job1;
-	job_info_t *job2;
-	char *name1, *name2;
+	squeue_job_rec_t *rec1;
+	squeue_job_rec_t *rec2;
 
-	_get_job_info_from_void(&job1, &job2, void1, void2);
+	_get_job_rec_from_void(&rec1, &rec2, void1, void2);
 
-	name1 = uid_to_string_cached((uid_t) job1->user_id);
-	name2 = uid_to_string_cached((uid_t) job2->user_id);
-	diff = xstrcmp(name1, name2);
+	diff = xstrcmp(rec1->user_name, rec2->user_name);
 
 	if (reverse_order)
 		diff = -diff;
@@ -143,7 +143,6 @@ extern void parse_command_line( int argc, char* *argv );
 extern int  parse_format( char* format );
 extern int  parse_long_format( char* format_long);
 extern void sort_job_list( List job_list );
-extern void sort_jobs_by_start_time( List job_list );
 extern void sort_step_list( List step_list );
 
 #endif
@@ -0,0 +1,25 @@
+############################################################################
+# Copyright (C) SchedMD LLC.
+############################################################################
+import atf
+import pytest
+
+
+@pytest.fixture(scope="module", autouse=True)
+def setup():
+    atf.require_nodes(3)
+    atf.require_slurm_running()
+
+
+def test_node_oriented():
+    """Verify sinfo --Node prints one line per node and partition"""
+
+    nodes = atf.get_nodes()
+    output = atf.run_command_output("sinfo --Node -h -o '%N %P'", fatal=True)
+    lines = output.splitlines()
+
+    assert len(lines) == len(set(lines)), "sinfo --Node printed duplicate lines"
+    for line in lines:
+        node_name = line.split()[0]
+        assert node_name in nodes, f"sinfo --Node merged nodes into '{node_name}'"
+    assert {line.split()[0] for line in lines} == set(nodes.keys())
@@ -0,0 +1,165 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/data.h"
+#include "src/common/extra_constraints.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+static elem_t *_parse(char *str)
+{
+	char *extra = xstrdup(str);
+	elem_t *head = NULL;
+
+	ck_assert_int_eq(extra_constraints_parse(extra, &head), SLURM_SUCCESS);
+	ck_assert(head != NULL);
+	xfree(extra);
+
+	return head;
+}
+
+/* Return the only leaf of a parsed single comparison */
+static elem_t *_leaf(elem_t *head)
+{
+	if (head->num_children) {
+		ck_assert_int_eq(head->num_children, 1);
+		return head->children[0];
+	}
+	return head;
+}
+
+static data_t *_node_data(void)
+{
+	data_t *data = data_set_dict(data_new());
+
+	data_set_int(data_key_set(data, "cpus"), 64);
+	data_set_float(data_key_set(data, "load"), 0.5);
+	data_set_bool(data_key_set(data, "gpu"), true);
+	data_set_string(data_key_set(data, "arch"), "x86_64");
+
+	return data;
+}
+
+static void _check_test(char *str, data_t *data, bool expect)
+{
+	elem_t *head = _parse(str);
+
+	ck_assert_msg(extra_constraints_test(head, data) == expect,
+		      "\"%s\" expected %s", str, expect ? "true" : "false");
+	FREE_NULL_EXTRA_CONSTRAINTS(head);
+}
+
+START_TEST(leaf_value_number)
+{
+	elem_t *head = _parse("cpus>=32.5");
+	elem_t *leaf = _leaf(head);
+
+	ck_assert_int_eq(leaf->operator, OP_LEAF_GTE);
+	ck_assert_str_eq(leaf->key, "cpus");
+	ck_assert_str_eq(leaf->value, "32.5");
+	ck_assert(leaf->value_float_valid);
+	ck_assert(leaf->value_float == 32.5);
+	FREE_NULL_EXTRA_CONSTRAINTS(head);
+}
+END_TEST
+
+START_TEST(leaf_value_bool)
+{
+	elem_t *head = _parse("gpu=true");
+	elem_t *leaf = _leaf(head);
+
+	ck_assert_int_eq(leaf->operator, OP_LEAF_EQ);
+	ck_assert(leaf->value_bool_valid);
+	ck_assert(leaf->value_bool);
+	FREE_NULL_EXTRA_CONSTRAINTS(head);
+}
+END_TEST
+
+START_TEST(leaf_value_string)
+{
+	elem_t *head = _parse("arch!=aarch64");
+	elem_t *leaf = _leaf(head);
+
+	ck_assert_int_eq(leaf->operator, OP_LEAF_NE);
+	ck_assert_str_eq(leaf->value, "aarch64");
+	ck_assert(!leaf->value_float_valid);
+	FREE_NULL_EXTRA_CONSTRAINTS(head);
+}
+END_TEST
+
+START_TEST(parse_invalid)
+{
+	char *bad[] = { "cpus", "cpus=>4", "cpus<>4", "cpus=4=5", "(cpus=4" };
+
+	for (int i = 0; i < ARRAY_SIZE(bad); i++) {
+		char *extra = xstrdup(bad[i]);
+		elem_t *head = NULL;
+
+		ck_assert_msg(extra_constraints_parse(extra, &head) ==
+			      ESLURM_INVALID_EXTRA, "\"%s\" parsed", bad[i]);
+		ck_assert(head == NULL);
+		xfree(extra);
+	}
+}
+END_TEST
+
+START_TEST(test_node_data)
+{
+	data_t *data = _node_data();
+
+	_check_test("cpus>=64", data, true);
+	_check_test("cpus>64", data, false);
+	_check_test("cpus<100.5", data, true);
+	_check_test("load<=0.5", data, true);
+	_check_test("load>0.5", data, false);
+	_check_test("gpu=true", data, true);
+	_check_test("gpu!=true", data, false);
+	_check_test("arch=x86_64", data, true);
+	_check_test("arch=aarch64", data, false);
+	/* A number can not be compared to a string */
+	_check_test("cpus=many", data, false);
+	/* Missing keys do not match */
+	_check_test("mem>0", data, false);
+	_check_test("cpus>=64&gpu=true", data, true);
+	_check_test("cpus>64|arch=x86_64", data, true);
+	_check_test("(cpus>64|load>1),gpu=true", data, false);
+
+	FREE_NULL_DATA(data);
+}
+END_TEST
+
+/*****************************************************************************
+ * TEST SUITE                                                                *
+ ****************************************************************************/
+
+Suite *extra_constraints_suite(void)
+{
+	Suite *s = suite_create("extra_constraints");
+	TCase *tc_core = tcase_create("Core");
+	tcase_add_test(tc_core, leaf_value_number);
+	tcase_add_test(tc_core, leaf_value_bool);
+	tcase_add_test(tc_core, leaf_value_string);
+	tcase_add_test(tc_core, parse_invalid);
+	tcase_add_test(tc_core, test_node_data);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+/*****************************************************************************
+ * TEST RUNNER                                                               *
+ ****************************************************************************/
+
+int main(void)
+{
+	int number_failed;
+	SRunner *sr = srunner_create(extra_constraints_suite());
+
+	extra_constraints_set_parsing(true);
+
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
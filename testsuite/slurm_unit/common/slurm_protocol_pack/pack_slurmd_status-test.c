@@ -0,0 +1,146 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/slurm_protocol_pack.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/common/slurm_protocol_common.h"
+
+static uint32_t prolog_hist[PREP_HIST_CNT] = { 1, 2, 3, 4, 5, 6 };
+static uint32_t epilog_hist[PREP_HIST_CNT] = { 11, 12, 13, 14, 15, 16 };
+static slurmd_status_t pack_req = {
+	.booted = 1000,
+	.last_slurmctld_msg = 2000,
+	.actual_cpus = 64,
+	.actual_real_mem = 256000,
+	.pid = 4321,
+	.hostname = "node1",
+	.version = "24.08",
+	.prep_queued = 7,
+	.prep_running = 8,
+	.prep_wait_max = 9000,
+	.prep_hist_cnt = PREP_HIST_CNT,
+	.prolog_hist = prolog_hist,
+	.epilog_hist = epilog_hist,
+};
+
+static slurmd_status_t *_pack_unpack(uint16_t protocol_version)
+{
+	int rc;
+	uint32_t packed;
+	buf_t *buf = init_buf(1024);
+	slurm_msg_t msg = {{0}};
+
+	msg.msg_type         = RESPONSE_SLURMD_STATUS;
+	msg.protocol_version = protocol_version;
+	msg.data             = &pack_req;
+
+	rc = pack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+
+	packed = get_buf_offset(buf);
+	set_buf_offset(buf, 0);
+
+	msg.data = NULL;
+	rc = unpack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+	ck_assert(msg.data != NULL);
+	/* The whole message must be consumed */
+	ck_assert_int_eq(get_buf_offset(buf), packed);
+
+	free_buf(buf);
+	return msg.data;
+}
+
+START_TEST(current_version)
+{
+	slurmd_status_t *unpack_resp = _pack_unpack(SLURM_PROTOCOL_VERSION);
+
+	ck_assert(unpack_resp->booted == pack_req.booted);
+	ck_assert(unpack_resp->last_slurmctld_msg ==
+		  pack_req.last_slurmctld_msg);
+	ck_assert(unpack_resp->actual_cpus == pack_req.actual_cpus);
+	ck_assert(unpack_resp->actual_real_mem == pack_req.actual_real_mem);
+	ck_assert(unpack_resp->pid == pack_req.pid);
+	ck_assert_str_eq(unpack_resp->hostname, pack_req.hostname);
+	ck_assert_str_eq(unpack_resp->version, pack_req.version);
+
+	ck_assert(unpack_resp->prep_queued == pack_req.prep_queued);
+	ck_assert(unpack_resp->prep_running == pack_req.prep_running);
+	ck_assert(unpack_resp->prep_wait_max == pack_req.prep_wait_max);
+	ck_assert_int_eq(unpack_resp->prep_hist_cnt, PREP_HIST_CNT);
+	for (int i = 0; i < PREP_HIST_CNT; i++) {
+		ck_assert(unpack_resp->prolog_hist[i] == prolog_hist[i]);
+		ck_assert(unpack_resp->epilog_hist[i] == epilog_hist[i]);
+	}
+
+	slurm_free_slurmd_status(unpack_resp);
+}
+END_TEST
+
+/* The prolog/epilog counters are not sent to older clients */
+START_TEST(one_back)
+{
+	slurmd_status_t *unpack_resp =
+		_pack_unpack(SLURM_ONE_BACK_PROTOCOL_VERSION);
+
+	ck_assert(unpack_resp->pid == pack_req.pid);
+	ck_assert_str_eq(unpack_resp->version, pack_req.version);
+	ck_assert(unpack_resp->prep_queued == 0);
+	ck_assert(unpack_resp->prep_running == 0);
+	ck_assert(unpack_resp->prep_wait_max == 0);
+	ck_assert(unpack_resp->prep_hist_cnt == 0);
+	ck_assert(unpack_resp->prolog_hist == NULL);
+	ck_assert(unpack_resp->epilog_hist == NULL);
+
+	slurm_free_slurmd_status(unpack_resp);
+}
+END_TEST
+
+START_TEST(hist_inx)
+{
+	ck_assert_int_eq(prep_hist_inx(0), 0);
+	ck_assert_int_eq(prep_hist_inx(99), 0);
+	ck_assert_int_eq(prep_hist_inx(100), 1);
+	ck_assert_int_eq(prep_hist_inx(999), 1);
+	ck_assert_int_eq(prep_hist_inx(1000), 2);
+	ck_assert_int_eq(prep_hist_inx(59999), 3);
+	ck_assert_int_eq(prep_hist_inx(60000), 4);
+	ck_assert_int_eq(prep_hist_inx(600000), PREP_HIST_CNT - 1);
+	ck_assert_int_eq(prep_hist_inx(UINT32_MAX), PREP_HIST_CNT - 1);
+	for (int i = 0; i < PREP_HIST_CNT; i++)
+		ck_assert(prep_hist_inx2str(i) != NULL);
+}
+END_TEST
+
+/*****************************************************************************
+ * TEST SUITE                                                                *
+ ****************************************************************************/
+
+Suite *suite(void)
+{
+	Suite *s = suite_create("Pack slurmd_status_t");
+	TCase *tc_core = tcase_create("Pack slurmd_status_t");
+	tcase_add_test(tc_core, current_version);
+	tcase_add_test(tc_core, one_back);
+	tcase_add_test(tc_core, hist_inx);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+/*****************************************************************************
+ * TEST RUNNER                                                               *
+ ****************************************************************************/
+
+int main(void)
+{
+	int number_failed;
+	SRunner *sr = srunner_create(suite());
+
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/slurm_protocol_pack.h"
+#include "src/common/xmalloc.h"
+#include "src/common/slurm_protocol_common.h"
+
+#define PREP_SCRIPT_INFLIGHT 101
+#define PREP_SCRIPT_CNT 102
+#define PREP_SCRIPT_QUEUE_SUM 0x100000003
+#define PREP_SCRIPT_QUEUE_MAX 104
+#define PREP_SCRIPT_RUN_SUM 0x200000005
+#define PREP_SCRIPT_RUN_MAX 106
+#define RPC_TYPE_SIZE 3
+
+/*
+ * RESPONSE_STATS_INFO is packed by slurmctld (pack_all_stat() and the RPC
+ * statistics), so build the message here in the same order.
+ */
+static buf_t *_pack_stats(uint16_t protocol_version)
+{
+	buf_t *buffer = init_buf(1024);
+	uint32_t exit_cnt[4] = { 1, 2, 3, 4 };
+
+	pack32(1, buffer);			/* parts_packed */
+	pack_time(10, buffer);			/* req_time */
+	pack_time(11, buffer);			/* req_time_start */
+	for (int i = 0; i < 13; i++)		/* threads - jobs_running */
+		pack32(i, buffer);
+	pack_time(12, buffer);			/* job_states_ts */
+	for (int i = 0; i < 5; i++)		/* schedule_cycle_* */
+		pack32(i, buffer);
+	pack32_array(exit_cnt, 4, buffer);	/* schedule_exit */
+	pack32(20, buffer);			/* schedule_queue_len */
+
+	pack32(21, buffer);			/* bf_backfilled_jobs */
+	pack32(22, buffer);			/* bf_last_backfilled_jobs */
+	pack32(23, buffer);			/* bf_cycle_counter */
+	pack64(24, buffer);			/* bf_cycle_sum */
+	for (int i = 0; i < 5; i++)		/* bf_cycle_last - max */
+		pack32(i, buffer);
+	pack_time(25, buffer);			/* bf_when_last_cycle */
+	for (int i = 0; i < 7; i++)		/* bf_depth_sum - het_jobs */
+		pack32(i, buffer);
+	pack32_array(exit_cnt, 4, buffer);	/* bf_exit */
+
+	if (protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		pack32(PREP_SCRIPT_INFLIGHT, buffer);
+		pack32(PREP_SCRIPT_CNT, buffer);
+		pack64(PREP_SCRIPT_QUEUE_SUM, buffer);
+		pack32(PREP_SCRIPT_QUEUE_MAX, buffer);
+		pack64(PREP_SCRIPT_RUN_SUM, buffer);
+		pack32(PREP_SCRIPT_RUN_MAX, buffer);
+	}
+
+	pack32(RPC_TYPE_SIZE, buffer);		/* rpc_type_size */
+	pack16_array(NULL, 0, buffer);
+	pack32_array(NULL, 0, buffer);
+	pack64_array(NULL, 0, buffer);
+	pack32(0, buffer);			/* rpc_user_size */
+	pack32_array(NULL, 0, buffer);
+	pack32_array(NULL, 0, buffer);
+	pack64_array(NULL, 0, buffer);
+	pack32_array(NULL, 0, buffer);		/* rpc_queue_type_id */
+	pack32_array(NULL, 0, buffer);		/* rpc_queue_count */
+	pack32_array(NULL, 0, buffer);		/* rpc_dump_types */
+	packstr_array(NULL, 0, buffer);		/* rpc_dump_hostlist */
+
+	return buffer;
+}
+
+static stats_info_response_msg_t *_unpack_stats(uint16_t protocol_version)
+{
+	int rc;
+	uint32_t packed;
+	buf_t *buf = _pack_stats(protocol_version);
+	slurm_msg_t msg = {{0}};
+
+	msg.msg_type         = RESPONSE_STATS_INFO;
+	msg.protocol_version = protocol_version;
+
+	packed = get_buf_offset(buf);
+	set_buf_offset(buf, 0);
+
+	rc = unpack_msg(&msg, buf);
+	ck_assert_int_eq(rc, SLURM_SUCCESS);
+	ck_assert(msg.data != NULL);
+	/* The whole message must be consumed */
+	ck_assert_int_eq(get_buf_offset(buf), packed);
+
+	free_buf(buf);
+	return msg.data;
+}
+
+START_TEST(current_version)
+{
+	stats_info_response_msg_t *resp =
+		_unpack_stats(SLURM_PROTOCOL_VERSION);
+
+	ck_assert(resp->bf_exit_cnt == 4);
+	ck_assert(resp->prep_script_inflight == PREP_SCRIPT_INFLIGHT);
+	ck_assert(resp->prep_script_cnt == PREP_SCRIPT_CNT);
+	ck_assert(resp->prep_script_queue_sum == PREP_SCRIPT_QUEUE_SUM);
+	ck_assert(resp->prep_script_queue_max == PREP_SCRIPT_QUEUE_MAX);
+	ck_assert(resp->prep_script_run_sum == PREP_SCRIPT_RUN_SUM);
+	ck_assert(resp->prep_script_run_max == PREP_SCRIPT_RUN_MAX);
+	ck_assert(resp->rpc_type_size == RPC_TYPE_SIZE);
+
+	slurm_free_stats_response_msg(resp);
+}
+END_TEST
+
+/* The prolog/epilog statistics are not sent to older clients */
+START_TEST(one_back)
+{
+	stats_info_response_msg_t *resp =
+		_unpack_stats(SLURM_ONE_BACK_PROTOCOL_VERSION);
+
+	ck_assert(resp->bf_exit_cnt == 4);
+	ck_assert(resp->prep_script_inflight == 0);
+	ck_assert(resp->prep_script_cnt == 0);
+	ck_assert(resp->prep_script_queue_sum == 0);
+	ck_assert(resp->prep_script_run_sum == 0);
+	ck_assert(resp->rpc_type_size == RPC_TYPE_SIZE);
+
+	slurm_free_stats_response_msg(resp);
+}
+END_TEST
+
+/*****************************************************************************
+ * TEST SUITE                                                                *
+ ****************************************************************************/
+
+Suite *suite(void)
+{
+	Suite *s = suite_create("Pack stats_info_response_msg_t");
+	TCase *tc_core = tcase_create("Pack stats_info_response_msg_t");
+	tcase_add_test(tc_core, current_version);
+	tcase_add_test(tc_core, one_back);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+/*****************************************************************************
+ * TEST RUNNER                                                               *
+ ****************************************************************************/
+
+int main(void)
+{
+	int number_failed;
+	SRunner *sr = srunner_create(suite());
+
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,239 @@
+/*
+ * Built in so that the layout cache can be inspected. These come first so
+ * that the plugin sees the system headers with its own feature macros.
+ */
+#include "src/plugins/task/affinity/dist_tasks.c"
+#include "src/plugins/task/affinity/numa.c"
+#include "src/plugins/task/affinity/schedutils.c"
+#include "src/interfaces/task.c"
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NODE_SOCKETS 2
+#define NODE_CORES 4
+#define NODE_THREADS 2
+#define NODE_CPUS (NODE_SOCKETS * NODE_CORES * NODE_THREADS)
+
+slurmd_conf_t *conf = NULL;
+
+static void _setup_conf(void)
+{
+	conf = xmalloc(sizeof(*conf));
+	conf->node_name = xstrdup("node1");
+	conf->sockets = conf->actual_sockets = NODE_SOCKETS;
+	conf->cores = conf->actual_cores = NODE_CORES;
+	conf->threads = conf->actual_threads = NODE_THREADS;
+	conf->cpus = conf->actual_cpus = NODE_CPUS;
+	conf->block_map_size = NODE_CPUS;
+	conf->block_map = xcalloc(NODE_CPUS, sizeof(uint16_t));
+	conf->block_map_inv = xcalloc(NODE_CPUS, sizeof(uint16_t));
+	for (int i = 0; i < NODE_CPUS; i++)
+		conf->block_map[i] = conf->block_map_inv[i] = i;
+}
+
+static void _free_conf(void)
+{
+	xfree(conf->node_name);
+	xfree(conf->block_map);
+	xfree(conf->block_map_inv);
+	xfree(conf);
+}
+
+/* Launch request for ntasks tasks of job 100 on the cores in core_list */
+static launch_tasks_request_msg_t *_create_req(char *core_list,
+					       uint16_t ntasks,
+					       uint16_t cpus_per_task,
+					       uint16_t cpu_bind_type,
+					       uint32_t task_dist)
+{
+	launch_tasks_request_msg_t *req = xmalloc(sizeof(*req));
+	slurm_cred_arg_t *arg;
+
+	req->step_id.job_id = 100;
+	req->step_id.step_id = 0;
+	req->step_id.step_het_comp = NO_VAL;
+	req->nnodes = 1;
+	req->tasks_to_launch = xcalloc(1, sizeof(uint16_t));
+	req->tasks_to_launch[0] = ntasks;
+	req->global_task_ids = xcalloc(1, sizeof(uint32_t *));
+	req->global_task_ids[0] = xcalloc(ntasks, sizeof(uint32_t));
+	for (int i = 0; i < ntasks; i++)
+		req->global_task_ids[0][i] = i;
+	req->cpus_per_task = cpus_per_task;
+	req->cpu_bind_type = cpu_bind_type;
+	req->task_dist = task_dist;
+	req->ntasks_per_core = NO_VAL16;
+	req->ntasks_per_socket = NO_VAL16;
+	req->threads_per_core = NO_VAL16;
+	req->job_core_spec = NO_VAL16;
+
+	req->cred = slurm_cred_alloc(true);
+	arg = req->cred->arg;
+	arg->step_id = req->step_id;
+	arg->job_hostlist = xstrdup(conf->node_name);
+	arg->job_nhosts = 1;
+	arg->job_core_spec = NO_VAL16;
+	arg->core_array_size = 1;
+	arg->sockets_per_node = xcalloc(1, sizeof(uint16_t));
+	arg->sockets_per_node[0] = NODE_SOCKETS;
+	arg->cores_per_socket = xcalloc(1, sizeof(uint16_t));
+	arg->cores_per_socket[0] = NODE_CORES;
+	arg->sock_core_rep_count = xcalloc(1, sizeof(uint32_t));
+	arg->sock_core_rep_count[0] = 1;
+	arg->job_core_bitmap = bit_alloc(NODE_SOCKETS * NODE_CORES);
+	bit_unfmt(arg->job_core_bitmap, core_list);
+	arg->step_core_bitmap = bit_copy(arg->job_core_bitmap);
+
+	return req;
+}
+
+static void _free_req(launch_tasks_request_msg_t *req)
+{
+	slurm_cred_destroy(req->cred);
+	xfree(req->tasks_to_launch);
+	xfree(req->global_task_ids[0]);
+	xfree(req->global_task_ids);
+	xfree(req->cpu_bind);
+	xfree(req);
+}
+
+static int _cache_count(void)
+{
+	return mask_cache ? list_count(mask_cache) : 0;
+}
+
+/*
+ * Lay out the same request with an empty cache and then again from the cache,
+ * and check that both give the same binding.
+ */
+static void _check_layout(char *core_list, uint16_t ntasks,
+			  uint16_t cpus_per_task, uint16_t cpu_bind_type,
+			  uint32_t task_dist)
+{
+	launch_tasks_request_msg_t *uncached, *cached;
+
+	lllp_distribution_fini();
+
+	uncached = _create_req(core_list, ntasks, cpus_per_task,
+			       cpu_bind_type, task_dist);
+	ck_assert_int_eq(lllp_distribution(uncached, 0, NULL), SLURM_SUCCESS);
+	ck_assert_int_eq(_cache_count(), 1);
+
+	cached = _create_req(core_list, ntasks, cpus_per_task,
+			     cpu_bind_type, task_dist);
+	ck_assert_int_eq(lllp_distribution(cached, 0, NULL), SLURM_SUCCESS);
+	/* Served from the cache, not laid out again */
+	ck_assert_int_eq(_cache_count(), 1);
+
+	ck_assert(uncached->cpu_bind != NULL);
+	ck_assert_str_eq(cached->cpu_bind, uncached->cpu_bind);
+	ck_assert_int_eq(cached->cpu_bind_type, uncached->cpu_bind_type);
+	ck_assert_int_eq(cached->cpus_per_task, uncached->cpus_per_task);
+
+	_free_req(uncached);
+	_free_req(cached);
+}
+
+START_TEST(cached_layout)
+{
+	uint16_t bind[] = { CPU_BIND_TO_THREADS, CPU_BIND_TO_CORES,
+			    CPU_BIND_TO_SOCKETS };
+	uint32_t dist[] = { SLURM_DIST_BLOCK_BLOCK, SLURM_DIST_BLOCK_CYCLIC,
+			    SLURM_DIST_CYCLIC_CFULL };
+
+	for (int b = 0; b < ARRAY_SIZE(bind); b++) {
+		for (int d = 0; d < ARRAY_SIZE(dist); d++) {
+			_check_layout("0-7", 4, 2, bind[b], dist[d]);
+			_check_layout("1-2,5", 3, 1, bind[b], dist[d]);
+			_check_layout("0-7", 16, 1, bind[b], dist[d]);
+		}
+	}
+}
+END_TEST
+
+/* A different allocation must not be served the binding of another one */
+START_TEST(different_cores)
+{
+	launch_tasks_request_msg_t *first, *second, *uncached;
+
+	lllp_distribution_fini();
+
+	first = _create_req("0-1", 2, 1, CPU_BIND_TO_CORES,
+			    SLURM_DIST_BLOCK_BLOCK);
+	ck_assert_int_eq(lllp_distribution(first, 0, NULL), SLURM_SUCCESS);
+
+	second = _create_req("4-5", 2, 1, CPU_BIND_TO_CORES,
+			     SLURM_DIST_BLOCK_BLOCK);
+	ck_assert_int_eq(lllp_distribution(second, 0, NULL), SLURM_SUCCESS);
+	ck_assert_int_eq(_cache_count(), 2);
+	ck_assert_str_ne(first->cpu_bind, second->cpu_bind);
+
+	lllp_distribution_fini();
+	uncached = _create_req("4-5", 2, 1, CPU_BIND_TO_CORES,
+			       SLURM_DIST_BLOCK_BLOCK);
+	ck_assert_int_eq(lllp_distribution(uncached, 0, NULL), SLURM_SUCCESS);
+	ck_assert_str_eq(second->cpu_bind, uncached->cpu_bind);
+
+	_free_req(first);
+	_free_req(second);
+	_free_req(uncached);
+}
+END_TEST
+
+/* Only the most recent MASK_CACHE_SIZE layouts are kept */
+START_TEST(cache_bound)
+{
+	lllp_distribution_fini();
+
+	for (int i = 0; i < (MASK_CACHE_SIZE + 4); i++) {
+		launch_tasks_request_msg_t *req =
+			_create_req("0-7", 2, 1, CPU_BIND_TO_CORES,
+				    SLURM_DIST_BLOCK_BLOCK);
+
+		req->step_id.job_id += i;
+		ck_assert_int_eq(lllp_distribution(req, 0, NULL),
+				 SLURM_SUCCESS);
+		_free_req(req);
+	}
+	ck_assert_int_eq(_cache_count(), MASK_CACHE_SIZE);
+	lllp_distribution_fini();
+}
+END_TEST
+
+/*****************************************************************************
+ * TEST SUITE                                                                *
+ ****************************************************************************/
+
+Suite *suite(void)
+{
+	Suite *s = suite_create("task/affinity lllp_distribution");
+	TCase *tc_core = tcase_create("lllp_distribution");
+	tcase_add_test(tc_core, cached_layout);
+	tcase_add_test(tc_core, different_cores);
+	tcase_add_test(tc_core, cache_bound);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+/*****************************************************************************
+ * TEST RUNNER                                                               *
+ ****************************************************************************/
+
+int main(void)
+{
+	int number_failed;
+	SRunner *sr = srunner_create(suite());
+
+	_setup_conf();
+
+	srunner_run_all(sr, CK_NORMAL);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	lllp_distribution_fini();
+	_free_conf();
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}